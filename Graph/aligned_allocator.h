@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+namespace DataStructure
+{
+    // 按 Align 字节对齐分配内存的分配器，配合 std::vector 使用
+    template <typename T, size_t Align = 64>
+    class AlignedAllocator
+    {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Align>;
+        };
+
+        AlignedAllocator() = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+        }
+
+        void deallocate(T* p, size_t)
+        {
+            ::operator delete(p, std::align_val_t(Align));
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Align>&) const
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Align>&) const
+        {
+            return false;
+        }
+    };
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "graph.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace DataStructure
+{
+    // A* 的工作区。距离数组只在 touched 记录的顶点上复原，多次查询之间复用时不再分配内存。
+    struct AStarScratch
+    {
+        void resize(size_t vertexCount);
+
+        DistanceHeap heap;
+        vector<int> dist;
+        vector<Vertex> parent;
+        vector<Vertex> touched;
+    };
+
+    inline void AStarScratch::resize(size_t vertexCount)
+    {
+        heap.resize(vertexCount);
+        dist.assign(vertexCount, INF);
+        parent.assign(vertexCount, vertexCount);
+        touched.clear();
+    }
+
+    // A* 求 from 到 to 的最短路，边权需非负。estimate(v) 返回 v 到 to 距离的下界；
+    // 下界不满足一致性时，已出堆的顶点被改进后会重新入堆，结果仍然正确。
+    // 不可达时返回 (INF, {})。neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)。
+    template <typename Estimate, typename Neighbors>
+    PathResult aStar(size_t vertexCount, Vertex from, Vertex to, Estimate&& estimate, Neighbors&& neighbors,
+                     AStarScratch& scratch)
+    {
+        if (scratch.dist.size() != vertexCount)
+        {
+            scratch.resize(vertexCount);
+        }
+
+        DistanceHeap& heap = scratch.heap;
+        vector<int>& dist = scratch.dist;
+        vector<Vertex>& parent = scratch.parent;
+        const Vertex none = vertexCount;
+
+        dist[from] = 0;
+        scratch.touched.push_back(from);
+        heap.push(from, estimate(from));
+
+        bool found = false;
+        while (!heap.empty())
+        {
+            Vertex v = heap.top();
+            heap.pop();
+            if (v == to)
+            {
+                found = true;
+                break;
+            }
+
+            int base = dist[v];
+            neighbors(v, [&](Vertex next, int weight) {
+                if (base + weight < dist[next])
+                {
+                    if (dist[next] == INF)
+                    {
+                        scratch.touched.push_back(next);
+                    }
+                    dist[next] = base + weight;
+                    parent[next] = v;
+                    heap.push_or_decrease(next, dist[next] + estimate(next));
+                }
+            });
+        }
+
+        PathResult result(INF, vector<Vertex>());
+        if (found)
+        {
+            result.first = dist[to];
+            for (Vertex v = to; v != none; v = parent[v])
+            {
+                result.second.push_back(v);
+            }
+            std::reverse(result.second.begin(), result.second.end());
+        }
+
+        for (Vertex v : scratch.touched)
+        {
+            dist[v] = INF;
+            parent[v] = none;
+        }
+        scratch.touched.clear();
+        heap.clear();
+
+        return result;
+    }
+}
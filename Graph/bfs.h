@@ -0,0 +1,181 @@
+#pragma once
+#include "graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace DataStructure
+{
+    // 以下 BFS 都忽略边权，返回每个顶点到起点的边数，不可达为 INF。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)。
+
+    template <typename Neighbors>
+    vector<int> breadthFirst(size_t vertexCount, Vertex start, Neighbors&& neighbors)
+    {
+        vector<int> level(vertexCount, INF);
+        vector<Vertex> frontier{start}, next;
+        level[start] = 0;
+
+        for (int depth = 1; !frontier.empty(); depth ++)
+        {
+            next.clear();
+            for (Vertex v : frontier)
+            {
+                neighbors(v, [&](Vertex to, int) {
+                    if (level[to] == INF)
+                    {
+                        level[to] = depth;
+                        next.push_back(to);
+                    }
+                });
+            }
+            frontier.swap(next);
+        }
+
+        return level;
+    }
+
+    // 方向优化 BFS 的切换阈值（Beamer 等人的 alpha / beta）：
+    // 前沿的出边数超过未访问顶点出边数的 1 / alpha 时改为自底向上，前沿顶点数少于 V / beta 时改回自顶向下
+    constexpr size_t BfsTopDownAlpha = 14;
+    constexpr size_t BfsBottomUpBeta = 24;
+
+    // 方向优化 BFS：前沿小时自顶向下扩展，前沿大时改为自底向上，让每个未访问顶点在前沿里找一个入边邻居，
+    // 找到就停，省掉大量重复检查。predecessors(v, visit) 需要对 v 的每条入边调用 visit(from, weight)，
+    // 并且在 visit 返回 true 时可以提前停止；degree(v) 返回 v 的出度。
+    template <typename Neighbors, typename Predecessors, typename Degree>
+    vector<int> directionOptimizingBfs(size_t vertexCount, Vertex start, Neighbors&& neighbors,
+                                       Predecessors&& predecessors, Degree&& degree)
+    {
+        vector<int> level(vertexCount, INF);
+        vector<Vertex> frontier{start}, next;
+        vector<uint64_t> inFrontier((vertexCount + 63) / 64, 0);
+        level[start] = 0;
+
+        size_t unexploredEdges = 0;
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            unexploredEdges += degree(v);
+        }
+        size_t frontierEdges = degree(start);
+        unexploredEdges -= frontierEdges;
+
+        bool bottomUp = false;
+        for (int depth = 1; !frontier.empty(); depth ++)
+        {
+            if (!bottomUp && frontierEdges * BfsTopDownAlpha > unexploredEdges)
+            {
+                bottomUp = true;
+            }
+            else if (bottomUp && frontier.size() * BfsBottomUpBeta < vertexCount)
+            {
+                bottomUp = false;
+            }
+
+            next.clear();
+            if (bottomUp)
+            {
+                std::fill(inFrontier.begin(), inFrontier.end(), 0);
+                for (Vertex v : frontier)
+                {
+                    inFrontier[v / 64] |= uint64_t(1) << (v % 64);
+                }
+
+                for (Vertex v = 0; v < vertexCount; v ++)
+                {
+                    if (level[v] != INF) continue;
+                    predecessors(v, [&](Vertex from, int) {
+                        if (inFrontier[from / 64] >> (from % 64) & 1)
+                        {
+                            level[v] = depth;
+                            next.push_back(v);
+                            return true;
+                        }
+                        return false;
+                    });
+                }
+            }
+            else
+            {
+                for (Vertex v : frontier)
+                {
+                    neighbors(v, [&](Vertex to, int) {
+                        if (level[to] == INF)
+                        {
+                            level[to] = depth;
+                            next.push_back(to);
+                        }
+                    });
+                }
+            }
+
+            frontierEdges = 0;
+            for (Vertex v : next)
+            {
+                frontierEdges += degree(v);
+            }
+            unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+            frontier.swap(next);
+        }
+
+        return level;
+    }
+
+    // 位并行的多源 BFS：每 64 个源点一组，每个顶点用一个 64 位掩码记录哪些源点已经到达它，
+    // 一遍遍历同时推进 64 个 BFS。结果第 i 行对应 sources[i]。
+    template <typename Neighbors>
+    DistanceMatrix multiSourceBfs(size_t vertexCount, const vector<Vertex>& sources, Neighbors&& neighbors)
+    {
+        DistanceMatrix ans(sources.size(), vertexCount);
+        vector<uint64_t> seen(vertexCount), frontier(vertexCount), next(vertexCount);
+
+        for (size_t base = 0; base < sources.size(); base += 64)
+        {
+            size_t group = std::min<size_t>(64, sources.size() - base);
+            std::fill(seen.begin(), seen.end(), 0);
+            std::fill(frontier.begin(), frontier.end(), 0);
+
+            for (size_t i = 0; i < group; i ++)
+            {
+                Vertex s = sources[base + i];
+                seen[s] |= uint64_t(1) << i;
+                frontier[s] |= uint64_t(1) << i;
+                ans(base + i, s) = 0;
+            }
+
+            for (int depth = 1; ; depth ++)
+            {
+                std::fill(next.begin(), next.end(), 0);
+                bool active = false;
+                for (Vertex v = 0; v < vertexCount; v ++)
+                {
+                    uint64_t bits = frontier[v];
+                    if (bits == 0) continue;
+                    neighbors(v, [&](Vertex to, int) {
+                        next[to] |= bits;
+                    });
+                }
+
+                for (Vertex v = 0; v < vertexCount; v ++)
+                {
+                    uint64_t fresh = next[v] & ~seen[v];
+                    next[v] = fresh;
+                    if (fresh == 0) continue;
+
+                    seen[v] |= fresh;
+                    active = true;
+                    while (fresh != 0)
+                    {
+                        ans(base + __builtin_ctzll(fresh), v) = depth;
+                        fresh &= fresh - 1;
+                    }
+                }
+
+                if (!active) break;
+                frontier.swap(next);
+            }
+        }
+
+        return ans;
+    }
+}
@@ -0,0 +1,328 @@
+#pragma once
+#include "graph.h"
+#include "graph_parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace DataStructure
+{
+    // (连通分量个数, 每个顶点所属分量的编号)，编号取 [0, 个数)
+    using ComponentResult = std::pair<size_t, vector<Vertex>>;
+
+    // 把任意的分量代表元换成按首次出现顺序编号的 [0, 个数)
+    inline ComponentResult denseComponents(vector<Vertex> label)
+    {
+        const Vertex none = ~Vertex(0);
+        vector<Vertex> id(label.size(), none);
+        size_t count = 0;
+        for (Vertex& l : label)
+        {
+            if (id[l] == none)
+            {
+                id[l] = count ++;
+            }
+            l = id[l];
+        }
+        return std::make_pair(count, std::move(label));
+    }
+
+    // 弱连通分量：按 Shiloach-Vishkin 的思路，对每条边把两端所在树中较大的根用 CAS 挂到较小的根上，
+    // 查找时顺带做路径减半，最后把每个顶点直接指向根。所有边只需并行扫描一遍。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)，并且可以被多个线程同时调用。
+    template <typename Neighbors>
+    ComponentResult weakComponents(size_t vertexCount, size_t threads, Neighbors&& neighbors)
+    {
+        vector<std::atomic<Vertex>> parent(vertexCount);
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            parent[v].store(v, std::memory_order_relaxed);
+        }
+
+        auto find = [&](Vertex v) {
+            while (true)
+            {
+                Vertex p = parent[v].load(std::memory_order_relaxed);
+                if (p == v) return v;
+                Vertex g = parent[p].load(std::memory_order_relaxed);
+                if (p != g)
+                {
+                    parent[v].compare_exchange_weak(p, g, std::memory_order_relaxed);
+                }
+                v = g;
+            }
+        };
+
+        auto hook = [&](Vertex a, Vertex b) {
+            while (true)
+            {
+                a = find(a);
+                b = find(b);
+                if (a == b) return;
+                if (a < b) std::swap(a, b);
+                Vertex expected = a;
+                if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+            }
+        };
+
+        parallelRange(vertexCount, threads, 1 << 10, [&](size_t, size_t begin, size_t end) {
+            for (Vertex v = begin; v < end; v ++)
+            {
+                neighbors(v, [&](Vertex to, int) {
+                    hook(v, to);
+                });
+            }
+        });
+
+        vector<Vertex> label(vertexCount);
+        parallelRange(vertexCount, threads, 1 << 12, [&](size_t, size_t begin, size_t end) {
+            for (Vertex v = begin; v < end; v ++)
+            {
+                label[v] = find(v);
+            }
+        });
+        return denseComponents(std::move(label));
+    }
+
+    // 非递归的 Tarjan 强连通分量。分量按逆拓扑序编号：编号小的分量不会有边指向编号大的分量。
+    // DFS 的每一层在 pending 中占一段连续区间存放尚未处理的邻居，所以 neighbors 只需支持回调式遍历。
+    template <typename Neighbors>
+    ComponentResult tarjanComponents(size_t vertexCount, Neighbors&& neighbors)
+    {
+        const Vertex none = ~Vertex(0);
+
+        struct Frame
+        {
+            Vertex v;
+            size_t begin;
+            size_t end;
+            size_t cursor;
+        };
+
+        vector<Vertex> index(vertexCount, none), low(vertexCount, 0), component(vertexCount, none);
+        vector<bool> onStack(vertexCount, false);
+        vector<Vertex> stack, pending;
+        vector<Frame> frames;
+        Vertex counter = 0;
+        size_t count = 0;
+
+        auto enter = [&](Vertex v) {
+            index[v] = low[v] = counter ++;
+            stack.push_back(v);
+            onStack[v] = true;
+
+            size_t begin = pending.size();
+            neighbors(v, [&](Vertex to, int) {
+                pending.push_back(to);
+            });
+            frames.push_back(Frame{v, begin, pending.size(), begin});
+        };
+
+        for (Vertex root = 0; root < vertexCount; root ++)
+        {
+            if (index[root] != none) continue;
+            enter(root);
+
+            while (!frames.empty())
+            {
+                size_t top = frames.size() - 1;
+                Vertex v = frames[top].v;
+
+                if (frames[top].cursor < frames[top].end)
+                {
+                    Vertex w = pending[frames[top].cursor ++];
+                    if (index[w] == none)
+                    {
+                        enter(w);
+                    }
+                    else if (onStack[w])
+                    {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+
+                if (low[v] == index[v])
+                {
+                    Vertex w;
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        onStack[w] = false;
+                        component[w] = count;
+                    } while (w != v);
+                    count ++;
+                }
+
+                pending.resize(frames[top].begin);
+                frames.pop_back();
+                if (!frames.empty())
+                {
+                    Vertex parent = frames.back().v;
+                    low[parent] = std::min(low[parent], low[v]);
+                }
+            }
+        }
+
+        return std::make_pair(count, std::move(component));
+    }
+
+    // 自顶向下剥离的轮数：每轮并行删掉在剩余图中没有入边或没有出边的顶点，它们各自构成单点分量
+    constexpr size_t ForwardBackwardTrimRounds = 3;
+
+    // 并行 forward-backward 强连通分量。先剥离单点分量，再反复处理互不相交的子问题：
+    // 在子问题内任选枢轴，正向可达集 F 与反向可达集 B 的交就是枢轴所在的分量，
+    // F \ B、B \ F 和其余顶点成为三个新的子问题。同一轮的子问题在多个线程上并行处理。
+    // predecessors(v, visit) 需要对 v 的每条入边调用 visit(from, weight)；两个访问函数都要能被多个线程同时调用。
+    template <typename Neighbors, typename Predecessors>
+    ComponentResult forwardBackwardComponents(size_t vertexCount, size_t threads, Neighbors&& neighbors,
+                                              Predecessors&& predecessors)
+    {
+        const size_t done = ~size_t(0);
+
+        // 每个子问题的顶点共享一个颜色，搜索只在同色顶点间进行；已确定分量的顶点为 done
+        vector<std::atomic<size_t>> color(vertexCount);
+        for (auto& c : color)
+        {
+            c.store(0, std::memory_order_relaxed);
+        }
+        vector<Vertex> label(vertexCount);
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            label[v] = v;
+        }
+
+        for (size_t round = 0; round < ForwardBackwardTrimRounds; round ++)
+        {
+            std::atomic<bool> trimmed(false);
+            parallelRange(vertexCount, threads, 1 << 10, [&](size_t, size_t begin, size_t end) {
+                for (Vertex v = begin; v < end; v ++)
+                {
+                    if (color[v].load(std::memory_order_relaxed) == done) continue;
+
+                    bool hasOut = false, hasIn = false;
+                    neighbors(v, [&](Vertex to, int) {
+                        hasOut = hasOut || color[to].load(std::memory_order_relaxed) != done;
+                    });
+                    predecessors(v, [&](Vertex from, int) {
+                        hasIn = hasIn || color[from].load(std::memory_order_relaxed) != done;
+                        return hasIn;
+                    });
+                    if (!hasOut || !hasIn)
+                    {
+                        color[v].store(done, std::memory_order_relaxed);
+                        trimmed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+            if (!trimmed.load(std::memory_order_relaxed)) break;
+        }
+
+        struct Task
+        {
+            size_t color;
+            vector<Vertex> vertices;
+        };
+
+        vector<Task> tasks(1, Task{0, {}});
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            if (color[v].load(std::memory_order_relaxed) != done)
+            {
+                tasks[0].vertices.push_back(v);
+            }
+        }
+        if (tasks[0].vertices.empty())
+        {
+            tasks.clear();
+        }
+
+        std::atomic<size_t> nextColor(1);
+        size_t workers = parallelWorkers(vertexCount, threads);
+        vector<vector<Task>> produced(workers);
+        vector<vector<Vertex>> queues(workers);
+
+        while (!tasks.empty())
+        {
+            parallelRange(tasks.size(), workers, 1, [&](size_t worker, size_t begin, size_t end) {
+                vector<Vertex>& queue = queues[worker];
+                for (size_t t = begin; t < end; t ++)
+                {
+                    Task& task = tasks[t];
+                    const size_t base = task.color;
+                    const size_t forward = nextColor.fetch_add(2, std::memory_order_relaxed);
+                    const size_t backward = forward + 1;
+                    const Vertex pivot = task.vertices.front();
+
+                    // 正向：同色顶点改成 forward
+                    queue.assign(1, pivot);
+                    color[pivot].store(forward, std::memory_order_relaxed);
+                    for (size_t i = 0; i < queue.size(); i ++)
+                    {
+                        neighbors(queue[i], [&](Vertex to, int) {
+                            if (color[to].load(std::memory_order_relaxed) == base)
+                            {
+                                color[to].store(forward, std::memory_order_relaxed);
+                                queue.push_back(to);
+                            }
+                        });
+                    }
+
+                    // 反向：forward 色的顶点属于枢轴的分量，base 色的改成 backward
+                    queue.assign(1, pivot);
+                    color[pivot].store(done, std::memory_order_relaxed);
+                    label[pivot] = pivot;
+                    for (size_t i = 0; i < queue.size(); i ++)
+                    {
+                        predecessors(queue[i], [&](Vertex from, int) {
+                            size_t c = color[from].load(std::memory_order_relaxed);
+                            if (c == forward)
+                            {
+                                color[from].store(done, std::memory_order_relaxed);
+                                label[from] = pivot;
+                                queue.push_back(from);
+                            }
+                            else if (c == base)
+                            {
+                                color[from].store(backward, std::memory_order_relaxed);
+                                queue.push_back(from);
+                            }
+                            return false;
+                        });
+                    }
+
+                    Task parts[3] = {Task{forward, {}}, Task{backward, {}}, Task{base, {}}};
+                    for (Vertex v : task.vertices)
+                    {
+                        size_t c = color[v].load(std::memory_order_relaxed);
+                        if (c == forward) parts[0].vertices.push_back(v);
+                        else if (c == backward) parts[1].vertices.push_back(v);
+                        else if (c == base) parts[2].vertices.push_back(v);
+                    }
+                    for (auto& part : parts)
+                    {
+                        if (!part.vertices.empty())
+                        {
+                            produced[worker].push_back(std::move(part));
+                        }
+                    }
+                    vector<Vertex>().swap(task.vertices);
+                }
+            });
+
+            tasks.clear();
+            for (auto& list : produced)
+            {
+                for (auto& task : list)
+                {
+                    tasks.push_back(std::move(task));
+                }
+                list.clear();
+            }
+        }
+
+        return denseComponents(std::move(label));
+    }
+}
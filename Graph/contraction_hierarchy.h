@@ -0,0 +1,605 @@
+#pragma once
+#include "graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DataStructure
+{
+    // 证据搜索（witness search）最多确定这么多个顶点，找不到更短的路就认为需要捷径；
+    // 只估计优先级时用更小的限制。限制只会多加捷径，不影响查询结果的正确性。
+    constexpr size_t ContractionWitnessLimit = 500;
+    constexpr size_t ContractionEstimateLimit = 50;
+
+    // 索引文件格式（小端）：ContractionHeader，之后依次为
+    //   rank        uint32_t[vertexCount]
+    //   upOffsets   uint64_t[vertexCount + 1]     upArcs   HierarchyArc[upCount]
+    //   downOffsets uint64_t[vertexCount + 1]     downArcs HierarchyArc[downCount]
+    constexpr char ContractionMagic[8] = {'D', 'S', 'C', 'H', 'I', 'D', 'X', '\0'};
+    constexpr uint32_t ContractionVersion = 1;
+
+    struct ContractionHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t vertexCount;
+        uint64_t upCount;
+        uint64_t downCount;
+    };
+
+    // 层次图中的一条弧。middle 为原图的边时是 HierarchyNoMiddle，
+    // 否则这条弧是经过 middle 的捷径，可以拆成两条弧。
+    constexpr uint32_t HierarchyNoMiddle = ~uint32_t(0);
+
+    struct HierarchyArc
+    {
+        uint32_t to;
+        int32_t weight;
+        uint32_t middle;
+    };
+
+    // 收缩层次（contraction hierarchies）。
+    // 预处理按 边差（新增捷径数 - 被删的边数）+ 已收缩邻居数 + 层数 的顺序逐个收缩顶点，
+    // 收缩 v 时，对每对 u -> v -> w，若不经过 v 找不到不更长的路，就加入捷径 u -> w。
+    // 查询时从起点沿 rank 升高的弧正向搜索、从终点沿 rank 升高的弧反向搜索，两边相遇的最小值即为最短距离。
+    // 边权需非负。查询复用内部的工作区，不能并发调用。
+    class ContractionHierarchy
+    {
+    public:
+        ContractionHierarchy() = default;
+        template <typename E>
+        explicit ContractionHierarchy(const Graph<E>& graph);
+
+        void save(const std::string& path) const;
+        static ContractionHierarchy load(const std::string& path);
+
+        int distance(Vertex from, Vertex to);
+        PathResult query(Vertex from, Vertex to);      // 返回展开捷径后的完整路径，不可达时为 (INF, {})
+
+        size_t vertexCount() const;
+        size_t arcCount() const;
+        uint32_t rank(Vertex v) const;
+
+    private:
+        struct Arc
+        {
+            Vertex to;
+            int weight;
+            uint32_t middle;
+        };
+
+        // 预处理时剩余图的邻接和证据搜索的工作区
+        struct Builder
+        {
+            Builder(size_t vertexCount);
+
+            int shortcuts(Vertex v, bool apply);
+            int priority(Vertex v);
+            void witnessSearch(Vertex source, Vertex skip, int limit, size_t settleLimit, size_t targets);
+            static void link(vector<Arc>& arcs, Vertex to, int weight, uint32_t middle);
+
+            vector<vector<Arc>> out;
+            vector<vector<Arc>> in;
+            vector<int> contractedNeighbors;
+            vector<int> level;                  // 比 v 先收缩的邻居中最大的层数 + 1
+            DistanceHeap heap;
+            vector<int> dist;
+            vector<Vertex> touched;
+            vector<bool> isTarget;              // 证据搜索要找的顶点，全部确定后可以提前结束
+        };
+
+        void build(size_t count, const EdgeMap& edges);
+        void freeze(const vector<vector<HierarchyArc>>& up, const vector<vector<HierarchyArc>>& down);
+        int search(Vertex from, Vertex to, Vertex& meet);
+        void unpack(Vertex from, Vertex to, uint32_t middle, vector<Vertex>& path) const;
+        uint32_t middleOf(Vertex from, Vertex to) const;
+
+    private:
+        size_t count = 0;
+        vector<uint32_t> ranks;
+        vector<uint64_t> upOffsets;         // 顶点 v 指向更高 rank 顶点的出弧
+        vector<HierarchyArc> upArcs;
+        vector<uint64_t> downOffsets;       // 更高 rank 顶点指向 v 的入弧，to 存的是弧的起点
+        vector<HierarchyArc> downArcs;
+
+        // 查询工作区，下标 0 为正向，1 为反向；parent 存上一顶点，parentMiddle 存所走弧的 middle
+        DistanceHeap heap[2];
+        vector<int> dist[2];
+        vector<Vertex> parent[2];
+        vector<uint32_t> parentMiddle[2];
+        vector<Vertex> touched;
+    };
+
+    template <typename E>
+    ContractionHierarchy::ContractionHierarchy(const Graph<E>& graph)
+    {
+        build(graph.vertexCount, graph.edges);
+    }
+
+    inline ContractionHierarchy::Builder::Builder(size_t vertexCount)
+        : out(vertexCount), in(vertexCount), contractedNeighbors(vertexCount, 0), level(vertexCount, 0),
+          heap(vertexCount), dist(vertexCount, INF), isTarget(vertexCount, false) {}
+
+    inline void ContractionHierarchy::Builder::link(vector<Arc>& arcs, Vertex to, int weight, uint32_t middle)
+    {
+        for (auto& arc : arcs)
+        {
+            if (arc.to == to)
+            {
+                if (weight < arc.weight)
+                {
+                    arc.weight = weight;
+                    arc.middle = middle;
+                }
+                return;
+            }
+        }
+        arcs.push_back(Arc{to, weight, middle});
+    }
+
+    // 在剩余图上从 source 出发、绕开 skip 做 Dijkstra。距离超过 limit、确定了 settleLimit 个顶点
+    // 或者 targets 个目标顶点都已确定时停止
+    inline void ContractionHierarchy::Builder::witnessSearch(Vertex source, Vertex skip, int limit,
+                                                            size_t settleLimit, size_t targets)
+    {
+        for (Vertex v : touched)
+        {
+            dist[v] = INF;
+        }
+        touched.clear();
+        heap.clear();
+
+        dist[source] = 0;
+        touched.push_back(source);
+        heap.push(source, 0);
+
+        size_t settled = 0;
+        while (!heap.empty() && settled < settleLimit && targets > 0)
+        {
+            Vertex v = heap.top();
+            int distance = heap.top_key();
+            heap.pop();
+            if (distance > limit) break;
+            settled ++;
+            if (isTarget[v])
+            {
+                targets --;
+            }
+
+            for (const auto& arc : out[v])
+            {
+                if (arc.to != skip && distance + arc.weight < dist[arc.to])
+                {
+                    if (dist[arc.to] == INF)
+                    {
+                        touched.push_back(arc.to);
+                    }
+                    dist[arc.to] = distance + arc.weight;
+                    heap.push_or_decrease(arc.to, dist[arc.to]);
+                }
+            }
+        }
+    }
+
+    // 统计收缩 v 需要的捷径数，apply 为 true 时把捷径加进剩余图
+    inline int ContractionHierarchy::Builder::shortcuts(Vertex v, bool apply)
+    {
+        int added = 0;
+        int longest = 0;
+        for (const auto& arc : out[v])
+        {
+            longest = std::max(longest, arc.weight);
+            isTarget[arc.to] = true;
+        }
+
+        // 先收集再添加，避免在遍历 in[v] 时修改它
+        vector<std::pair<Vertex, Arc>> pending;
+        for (const auto& first : in[v])
+        {
+            Vertex u = first.to;
+            witnessSearch(u, v, first.weight + longest, apply ? ContractionWitnessLimit : ContractionEstimateLimit,
+                          out[v].size());
+
+            for (const auto& second : out[v])
+            {
+                Vertex w = second.to;
+                if (w == u) continue;
+
+                int via = first.weight + second.weight;
+                if (dist[w] > via)
+                {
+                    added ++;
+                    if (apply)
+                    {
+                        pending.emplace_back(u, Arc{w, via, static_cast<uint32_t>(v)});
+                    }
+                }
+            }
+        }
+
+        for (const auto& arc : out[v])
+        {
+            isTarget[arc.to] = false;
+        }
+
+        for (const auto& item : pending)
+        {
+            link(out[item.first], item.second.to, item.second.weight, item.second.middle);
+            link(in[item.second.to], item.first, item.second.weight, item.second.middle);
+        }
+        return added;
+    }
+
+    inline int ContractionHierarchy::Builder::priority(Vertex v)
+    {
+        int removed = static_cast<int>(in[v].size() + out[v].size());
+        return shortcuts(v, false) - removed + contractedNeighbors[v] + level[v];
+    }
+
+    inline void ContractionHierarchy::build(size_t vertexCount, const EdgeMap& edges)
+    {
+        count = vertexCount;
+        Builder builder(count);
+        for (const auto& e : edges)
+        {
+            if (e.weight < 0)
+            {
+                throw std::runtime_error("ContractionHierarchy: negative edge weight");
+            }
+            builder.out[e.from].push_back(Arc{e.to, e.weight, HierarchyNoMiddle});
+            builder.in[e.to].push_back(Arc{e.from, e.weight, HierarchyNoMiddle});
+        }
+
+        // 优先级可能变大也可能变小，所以不在堆里调整，而是压入新项，取出时丢掉与 current 不符的旧项。
+        // 收缩一个顶点后重新计算它邻居的优先级；取出时再算一次，比堆顶差就放回去。
+        using Entry = std::pair<int, Vertex>;
+        std::priority_queue<Entry, vector<Entry>, std::greater<Entry>> order;
+        vector<int> current(count);
+        vector<bool> contracted(count, false);
+        for (Vertex v = 0; v < count; v ++)
+        {
+            current[v] = builder.priority(v);
+            order.emplace(current[v], v);
+        }
+
+        ranks.assign(count, 0);
+        vector<vector<HierarchyArc>> up(count), down(count);
+        vector<Vertex> neighbors;
+        uint32_t next = 0;
+
+        while (!order.empty())
+        {
+            Entry top = order.top();
+            order.pop();
+            Vertex v = top.second;
+            if (contracted[v] || top.first != current[v]) continue;
+
+            current[v] = builder.priority(v);
+            if (!order.empty() && current[v] > order.top().first)
+            {
+                order.emplace(current[v], v);
+                continue;
+            }
+
+            builder.shortcuts(v, true);
+            contracted[v] = true;
+            ranks[v] = next ++;
+            neighbors.clear();
+
+            // v 剩下的弧两端都比 v 晚收缩，它们就是层次图中 v 的上行弧和下行弧
+            for (const auto& arc : builder.out[v])
+            {
+                up[v].push_back(HierarchyArc{static_cast<uint32_t>(arc.to), arc.weight, arc.middle});
+                auto& back = builder.in[arc.to];
+                back.erase(std::remove_if(back.begin(), back.end(), [v](const Arc& a) { return a.to == v; }), back.end());
+                builder.contractedNeighbors[arc.to] ++;
+                builder.level[arc.to] = std::max(builder.level[arc.to], builder.level[v] + 1);
+                neighbors.push_back(arc.to);
+            }
+            for (const auto& arc : builder.in[v])
+            {
+                down[v].push_back(HierarchyArc{static_cast<uint32_t>(arc.to), arc.weight, arc.middle});
+                auto& forth = builder.out[arc.to];
+                forth.erase(std::remove_if(forth.begin(), forth.end(), [v](const Arc& a) { return a.to == v; }), forth.end());
+                builder.contractedNeighbors[arc.to] ++;
+                builder.level[arc.to] = std::max(builder.level[arc.to], builder.level[v] + 1);
+                neighbors.push_back(arc.to);
+            }
+            vector<Arc>().swap(builder.out[v]);
+            vector<Arc>().swap(builder.in[v]);
+
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            for (Vertex w : neighbors)
+            {
+                current[w] = builder.priority(w);
+                order.emplace(current[w], w);
+            }
+        }
+
+        freeze(up, down);
+    }
+
+    inline void ContractionHierarchy::freeze(const vector<vector<HierarchyArc>>& up, const vector<vector<HierarchyArc>>& down)
+    {
+        auto flatten = [this](const vector<vector<HierarchyArc>>& lists, vector<uint64_t>& offsets, vector<HierarchyArc>& arcs) {
+            offsets.assign(count + 1, 0);
+            for (Vertex v = 0; v < count; v ++)
+            {
+                offsets[v + 1] = offsets[v] + lists[v].size();
+            }
+            arcs.clear();
+            arcs.reserve(offsets[count]);
+            for (const auto& list : lists)
+            {
+                arcs.insert(arcs.end(), list.begin(), list.end());
+            }
+        };
+        flatten(up, upOffsets, upArcs);
+        flatten(down, downOffsets, downArcs);
+    }
+
+    inline void ContractionHierarchy::save(const std::string& path) const
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("ContractionHierarchy: cannot open " + path);
+        }
+
+        ContractionHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, ContractionMagic, sizeof(header.magic));
+        header.version = ContractionVersion;
+        header.vertexCount = count;
+        header.upCount = upArcs.size();
+        header.downCount = downArcs.size();
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(ranks.data()), sizeof(uint32_t) * ranks.size());
+        out.write(reinterpret_cast<const char*>(upOffsets.data()), sizeof(uint64_t) * upOffsets.size());
+        out.write(reinterpret_cast<const char*>(upArcs.data()), sizeof(HierarchyArc) * upArcs.size());
+        out.write(reinterpret_cast<const char*>(downOffsets.data()), sizeof(uint64_t) * downOffsets.size());
+        out.write(reinterpret_cast<const char*>(downArcs.data()), sizeof(HierarchyArc) * downArcs.size());
+
+        if (!out)
+        {
+            throw std::runtime_error("ContractionHierarchy: write failed for " + path);
+        }
+    }
+
+    inline ContractionHierarchy ContractionHierarchy::load(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("ContractionHierarchy: cannot open " + path);
+        }
+
+        ContractionHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            throw std::runtime_error("ContractionHierarchy: truncated file " + path);
+        }
+        if (std::memcmp(header.magic, ContractionMagic, sizeof(ContractionMagic)) != 0)
+        {
+            throw std::runtime_error("ContractionHierarchy: bad magic in " + path);
+        }
+        if (header.version != ContractionVersion)
+        {
+            throw std::runtime_error("ContractionHierarchy: unsupported version in " + path);
+        }
+
+        ContractionHierarchy result;
+        result.count = header.vertexCount;
+        result.ranks.resize(header.vertexCount);
+        result.upOffsets.resize(header.vertexCount + 1);
+        result.upArcs.resize(header.upCount);
+        result.downOffsets.resize(header.vertexCount + 1);
+        result.downArcs.resize(header.downCount);
+
+        in.read(reinterpret_cast<char*>(result.ranks.data()), sizeof(uint32_t) * result.ranks.size());
+        in.read(reinterpret_cast<char*>(result.upOffsets.data()), sizeof(uint64_t) * result.upOffsets.size());
+        in.read(reinterpret_cast<char*>(result.upArcs.data()), sizeof(HierarchyArc) * result.upArcs.size());
+        in.read(reinterpret_cast<char*>(result.downOffsets.data()), sizeof(uint64_t) * result.downOffsets.size());
+        in.read(reinterpret_cast<char*>(result.downArcs.data()), sizeof(HierarchyArc) * result.downArcs.size());
+
+        if (!in || result.upOffsets[result.count] != header.upCount || result.downOffsets[result.count] != header.downCount)
+        {
+            throw std::runtime_error("ContractionHierarchy: truncated file " + path);
+        }
+        return result;
+    }
+
+    inline size_t ContractionHierarchy::vertexCount() const
+    {
+        return count;
+    }
+
+    inline size_t ContractionHierarchy::arcCount() const
+    {
+        return upArcs.size() + downArcs.size();
+    }
+
+    inline uint32_t ContractionHierarchy::rank(Vertex v) const
+    {
+        if (v >= count)
+        {
+            throw std::out_of_range("rank: Vertex out of range");
+        }
+        return ranks[v];
+    }
+
+    // 双向上行搜索，返回最短距离，meet 为取到最短距离的相遇顶点。工作区用完后复原。
+    inline int ContractionHierarchy::search(Vertex from, Vertex to, Vertex& meet)
+    {
+        if (from >= count || to >= count)
+        {
+            throw std::out_of_range("ContractionHierarchy: Vertex out of range");
+        }
+
+        if (dist[0].size() != count)
+        {
+            for (int side = 0; side < 2; side ++)
+            {
+                heap[side].resize(count);
+                dist[side].assign(count, INF);
+                parent[side].assign(count, count);
+                parentMiddle[side].assign(count, HierarchyNoMiddle);
+            }
+        }
+
+        for (Vertex v : touched)
+        {
+            for (int side = 0; side < 2; side ++)
+            {
+                dist[side][v] = INF;
+                parent[side][v] = count;
+            }
+        }
+        touched.clear();
+        heap[0].clear();
+        heap[1].clear();
+
+        int best = INF;
+        meet = count;
+
+        auto reach = [&](int side, Vertex v, int distance, Vertex from, uint32_t middle) {
+            if (dist[0][v] == INF && dist[1][v] == INF)
+            {
+                touched.push_back(v);
+            }
+            dist[side][v] = distance;
+            parent[side][v] = from;
+            parentMiddle[side][v] = middle;
+            heap[side].push_or_decrease(v, distance);
+
+            if (dist[1 - side][v] != INF && distance + dist[1 - side][v] < best)
+            {
+                best = distance + dist[1 - side][v];
+                meet = v;
+            }
+        };
+
+        reach(0, from, 0, count, HierarchyNoMiddle);
+        reach(1, to, 0, count, HierarchyNoMiddle);
+
+        // 上行搜索不能在两侧堆顶之和超过 best 时停止，只有某一侧堆顶本身不小于 best 时那一侧才结束
+        while (true)
+        {
+            bool open[2] = {!heap[0].empty() && heap[0].top_key() < best, !heap[1].empty() && heap[1].top_key() < best};
+            if (!open[0] && !open[1]) break;
+
+            int side = open[0] && (!open[1] || heap[0].top_key() <= heap[1].top_key()) ? 0 : 1;
+            Vertex v = heap[side].top();
+            int distance = heap[side].top_key();
+            heap[side].pop();
+
+            const vector<uint64_t>& offsets = side == 0 ? upOffsets : downOffsets;
+            const vector<HierarchyArc>& arcs = side == 0 ? upArcs : downArcs;
+            for (uint64_t i = offsets[v]; i < offsets[v + 1]; i ++)
+            {
+                const HierarchyArc& arc = arcs[i];
+                if (distance + arc.weight < dist[side][arc.to])
+                {
+                    reach(side, arc.to, distance + arc.weight, v, arc.middle);
+                }
+            }
+        }
+
+        return best;
+    }
+
+    inline int ContractionHierarchy::distance(Vertex from, Vertex to)
+    {
+        Vertex meet;
+        return search(from, to, meet);
+    }
+
+    inline PathResult ContractionHierarchy::query(Vertex from, Vertex to)
+    {
+        Vertex meet;
+        int best = search(from, to, meet);
+
+        vector<Vertex> path;
+        if (meet == count)
+        {
+            return std::make_pair(best, std::move(path));
+        }
+
+        // 正向部分先按逆序收集层次图上的弧，再依次展开
+        vector<std::pair<Vertex, uint32_t>> hops;
+        for (Vertex v = meet; parent[0][v] != count; v = parent[0][v])
+        {
+            hops.emplace_back(v, parentMiddle[0][v]);
+        }
+        std::reverse(hops.begin(), hops.end());
+
+        path.push_back(from);
+        for (const auto& hop : hops)
+        {
+            unpack(path.back(), hop.first, hop.second, path);
+        }
+        for (Vertex v = meet; parent[1][v] != count; v = parent[1][v])
+        {
+            unpack(v, parent[1][v], parentMiddle[1][v], path);
+        }
+
+        return std::make_pair(best, std::move(path));
+    }
+
+    // 把弧 from -> to 展开成原图上的路径，追加 from 之后的顶点
+    inline void ContractionHierarchy::unpack(Vertex from, Vertex to, uint32_t middle, vector<Vertex>& path) const
+    {
+        struct Segment
+        {
+            Vertex from;
+            Vertex to;
+            uint32_t middle;
+        };
+
+        vector<Segment> stack{Segment{from, to, middle}};
+        while (!stack.empty())
+        {
+            Segment s = stack.back();
+            stack.pop_back();
+            if (s.middle == HierarchyNoMiddle)
+            {
+                path.push_back(s.to);
+                continue;
+            }
+
+            Vertex m = s.middle;
+            stack.push_back(Segment{m, s.to, middleOf(m, s.to)});
+            stack.push_back(Segment{s.from, m, middleOf(s.from, m)});
+        }
+    }
+
+    // 查找弧 from -> to 的 middle。捷径经过的顶点 rank 低于两端，所以两段都能在较低的一端找到
+    inline uint32_t ContractionHierarchy::middleOf(Vertex from, Vertex to) const
+    {
+        if (ranks[from] < ranks[to])
+        {
+            for (uint64_t i = upOffsets[from]; i < upOffsets[from + 1]; i ++)
+            {
+                if (upArcs[i].to == to) return upArcs[i].middle;
+            }
+        }
+        else
+        {
+            for (uint64_t i = downOffsets[to]; i < downOffsets[to + 1]; i ++)
+            {
+                if (downArcs[i].to == from) return downArcs[i].middle;
+            }
+        }
+        throw std::logic_error("ContractionHierarchy: missing arc while unpacking a shortcut");
+    }
+}
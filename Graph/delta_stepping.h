@@ -0,0 +1,144 @@
+#pragma once
+#include "graph.h"
+#include "graph_parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace DataStructure
+{
+    // 桶里的顶点少于这个数时串行松弛，避免每个阶段都起线程
+    constexpr size_t DeltaSteppingParallelThreshold = 4096;
+
+    // Delta-stepping 单源最短路（要求边权非负）。
+    // 顶点按 dist / delta 放进桶，依次处理最小的非空桶：先反复松弛桶内顶点的轻边(w <= delta)直到桶空，
+    // 再统一松弛这些顶点的重边。同一个桶内的松弛在多个线程上并行，距离用原子 min 更新。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)，并且可以被多个线程同时调用。
+    // delta 为 0 时取 最大边权 / 平均出度。
+    template <typename Neighbors>
+    vector<int> deltaStepping(size_t vertexCount, Vertex start, int delta, size_t threads, Neighbors&& neighbors)
+    {
+        int maxWeight = 0;
+        size_t edgeCount = 0;
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            neighbors(v, [&](Vertex, int weight) {
+                maxWeight = std::max(maxWeight, weight);
+                edgeCount ++;
+            });
+        }
+
+        if (delta <= 0)
+        {
+            size_t degree = std::max<size_t>(1, edgeCount / std::max<size_t>(1, vertexCount));
+            delta = std::max(1, static_cast<int>(maxWeight / degree));
+        }
+
+        vector<std::atomic<int>> dist(vertexCount);
+        for (auto& d : dist)
+        {
+            d.store(INF, std::memory_order_relaxed);
+        }
+
+        // 所有未处理的距离都落在 [当前桶, 当前桶 + maxWeight / delta] 内，循环使用这么多个桶即可
+        const size_t bucketCount = maxWeight / delta + 2;
+        vector<vector<Vertex>> buckets(bucketCount);
+        size_t pending = 0;
+
+        auto bucketOf = [&](int d) { return static_cast<size_t>(d / delta); };
+        auto place = [&](Vertex v) {
+            buckets[bucketOf(dist[v].load(std::memory_order_relaxed)) % bucketCount].push_back(v);
+            pending ++;
+        };
+
+        size_t workers = parallelWorkers(vertexCount, threads);
+        vector<vector<Vertex>> improved(workers);
+
+        // 并行松弛 frontier 中顶点的轻边或重边，被改进的顶点重新入桶
+        auto relax = [&](const vector<Vertex>& frontier, bool light) {
+            size_t use = frontier.size() >= DeltaSteppingParallelThreshold ? workers : 1;
+            parallelRange(frontier.size(), use, 256, [&](size_t worker, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i ++)
+                {
+                    Vertex v = frontier[i];
+                    int base = dist[v].load(std::memory_order_relaxed);
+                    neighbors(v, [&](Vertex to, int weight) {
+                        if ((weight <= delta) == light && atomicMin(dist[to], base + weight))
+                        {
+                            improved[worker].push_back(to);
+                        }
+                    });
+                }
+            });
+            for (auto& list : improved)
+            {
+                for (Vertex v : list)
+                {
+                    place(v);
+                }
+                list.clear();
+            }
+        };
+
+        vector<char> inFrontier(vertexCount, 0);
+        vector<char> settled(vertexCount, 0);
+        vector<Vertex> frontier;
+        vector<Vertex> removed;
+
+        dist[start].store(0, std::memory_order_relaxed);
+        place(start);
+
+        size_t current = 0;
+        while (pending > 0)
+        {
+            while (buckets[current % bucketCount].empty())
+            {
+                current ++;
+            }
+
+            removed.clear();
+            auto& bucket = buckets[current % bucketCount];
+            while (!bucket.empty())
+            {
+                frontier.clear();
+                for (Vertex v : bucket)
+                {
+                    // 桶里可能有过期或重复的项，只取当前确实属于这个桶的顶点
+                    if (!inFrontier[v] && bucketOf(dist[v].load(std::memory_order_relaxed)) == current)
+                    {
+                        inFrontier[v] = 1;
+                        frontier.push_back(v);
+                    }
+                }
+                pending -= bucket.size();
+                bucket.clear();
+
+                for (Vertex v : frontier)
+                {
+                    inFrontier[v] = 0;
+                    if (!settled[v])
+                    {
+                        settled[v] = 1;
+                        removed.push_back(v);
+                    }
+                }
+
+                relax(frontier, true);
+            }
+
+            for (Vertex v : removed)
+            {
+                settled[v] = 0;
+            }
+            relax(removed, false);
+            current ++;
+        }
+
+        vector<int> ans(vertexCount);
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            ans[v] = dist[v].load(std::memory_order_relaxed);
+        }
+        return ans;
+    }
+}
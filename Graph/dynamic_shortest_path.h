@@ -0,0 +1,310 @@
+#pragma once
+#include "graph.h"
+#include "graph_list.h"
+#include "shortest_path_tree.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace DataStructure
+{
+    // 挂在 GraphList 上、固定起点的增量最短路，边权需非负。
+    // 通过本对象修改边时只修复受影响的部分：权值变小时从变化的边开始做局部 Dijkstra；
+    // 最短路树上的边变大或被删除时，把其下方的子树作废，用子树外的入边重新给子树定初值再做局部 Dijkstra。
+    // 直接修改图（不经过本对象）也可以，下次调用时发现边集版本变化会整体重算一次。
+    template <typename E>
+    class DynamicShortestPath
+    {
+    public:
+        DynamicShortestPath(GraphList<E>& graph, Vertex source);
+
+        void addEdge(Vertex from, Vertex to, int weight = 1);   // 与 GraphList::addEdge 相同，平行边取最小权值
+        void removeEdge(Vertex from, Vertex to);
+        // 批量修改：把 from -> to 的边设成 weight（weight 为 INF 表示删除），所有修改完成后统一修复一次
+        void update(const vector<Edge>& changes);
+
+        Vertex source() const;
+        int distance(Vertex v);
+        const vector<int>& distances();
+        const vector<Vertex>& predecessors();
+        PredecessorPath path(Vertex to);                        // 从 to 走回起点，见 shortest_path_tree.h
+        size_t lastRepairSize() const;                          // 上一次修复中重新入堆的顶点数
+
+    private:
+        struct Change
+        {
+            Vertex from;
+            Vertex to;
+            int before;     // 修改前后 from -> to 的有效权值，INF 表示没有这条边
+            int after;
+        };
+
+        int weightOf(Vertex from, Vertex to) const;
+        void check(Vertex from, Vertex to, int weight) const;
+        void sync();
+        void rebuild();
+        void repair(const vector<Change>& changes);
+
+        GraphList<E>& graph;
+        Vertex start;
+        vector<int> dist;
+        vector<Vertex> pred;
+        vector<vector<Vertex>> in;          // 每个顶点的入边起点，权值到 graph.edges 里查
+        vector<bool> affected;
+        vector<Vertex> affectedList;
+        ShortestPathScratch scratch;
+        uint64_t knownVersion;              // 与 dist 一致时图的边集版本
+        size_t repaired = 0;
+    };
+
+    template <typename E>
+    DynamicShortestPath<E>::DynamicShortestPath(GraphList<E>& graph, Vertex source)
+        : graph(graph), start(source), scratch(graph.vertexCount)
+    {
+        if (source >= graph.vertexCount)
+        {
+            throw std::out_of_range("DynamicShortestPath: source vertex out of range");
+        }
+        rebuild();
+    }
+
+    template <typename E>
+    int DynamicShortestPath<E>::weightOf(Vertex from, Vertex to) const
+    {
+        const int* weight = graph.edges.find(from, to);
+        return weight == nullptr ? INF : *weight;
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::check(Vertex from, Vertex to, int weight) const
+    {
+        if (from >= graph.vertexCount || to >= graph.vertexCount)
+        {
+            throw std::out_of_range("DynamicShortestPath: vertex out of range");
+        }
+        if (weight < 0)
+        {
+            throw std::runtime_error("DynamicShortestPath: negative edge weight");
+        }
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::sync()
+    {
+        if (graph.edges.version() != knownVersion)
+        {
+            rebuild();
+        }
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::rebuild()
+    {
+        const size_t n = graph.vertexCount;
+        in.assign(n, {});
+        for (const auto& e : graph.edges)
+        {
+            if (e.weight < 0)
+            {
+                throw std::runtime_error("DynamicShortestPath: negative edge weight");
+            }
+            in[e.to].push_back(e.from);
+        }
+
+        graph.Dijkstra(start, dist, pred, scratch);
+        affected.assign(n, false);
+        knownVersion = graph.edges.version();
+        repaired = n;
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::addEdge(Vertex from, Vertex to, int weight)
+    {
+        check(from, to, weight);
+        sync();
+
+        int before = weightOf(from, to);
+        graph.addEdge(from, to, weight);
+        repair({Change{from, to, before, weightOf(from, to)}});
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::removeEdge(Vertex from, Vertex to)
+    {
+        check(from, to, 0);
+        sync();
+
+        int before = weightOf(from, to);
+        graph.removeEdge(from, to);
+        repair({Change{from, to, before, INF}});
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::update(const vector<Edge>& changes)
+    {
+        for (const auto& e : changes)
+        {
+            check(e.from, e.to, e.weight);
+        }
+        sync();
+
+        vector<Change> applied;
+        applied.reserve(changes.size());
+        for (const auto& e : changes)
+        {
+            int before = weightOf(e.from, e.to);
+            graph.removeEdge(e.from, e.to);
+            if (e.weight != INF)
+            {
+                graph.addEdge(e.from, e.to, e.weight);
+            }
+            applied.push_back(Change{e.from, e.to, before, weightOf(e.from, e.to)});
+        }
+        repair(applied);
+    }
+
+    template <typename E>
+    void DynamicShortestPath<E>::repair(const vector<Change>& changes)
+    {
+        DistanceHeap& heap = scratch.heap;
+        affectedList.clear();
+
+        for (const auto& c : changes)
+        {
+            if (c.before == INF && c.after != INF)
+            {
+                in[c.to].push_back(c.from);
+            }
+            else if (c.before != INF && c.after == INF)
+            {
+                in[c.to].erase(std::find(in[c.to].begin(), in[c.to].end(), c.from));
+            }
+        }
+
+        // 变大或删除的树边：作废 to 的整棵子树。子树中的边都在图里，沿出边找 pred 指回来的顶点即可
+        for (const auto& c : changes)
+        {
+            if (c.after <= c.before || pred[c.to] != c.from || affected[c.to]) continue;
+
+            size_t head = affectedList.size();
+            affected[c.to] = true;
+            affectedList.push_back(c.to);
+            while (head < affectedList.size())
+            {
+                Vertex v = affectedList[head ++];
+                graph.forEachNeighbor(v, [&](Vertex to, int) {
+                    if (!affected[to] && pred[to] == v)
+                    {
+                        affected[to] = true;
+                        affectedList.push_back(to);
+                    }
+                });
+            }
+        }
+
+        for (Vertex v : affectedList)
+        {
+            dist[v] = INF;
+            pred[v] = NoVertex;
+        }
+
+        // 被作废的顶点先用子树外的入边定初值
+        auto offer = [&](Vertex v, Vertex from, int distance) {
+            if (distance < dist[v])
+            {
+                dist[v] = distance;
+                pred[v] = from;
+                heap.push_or_decrease(v, distance);
+            }
+        };
+
+        for (Vertex v : affectedList)
+        {
+            for (Vertex from : in[v])
+            {
+                if (!affected[from] && dist[from] != INF)
+                {
+                    offer(v, from, dist[from] + weightOf(from, v));
+                }
+            }
+        }
+
+        // 变小或新增的边。同一批里可能又改过，按当前权值算
+        for (const auto& c : changes)
+        {
+            int weight = weightOf(c.from, c.to);
+            if (c.after < c.before && weight != INF && dist[c.from] != INF)
+            {
+                offer(c.to, c.from, dist[c.from] + weight);
+            }
+        }
+
+        for (Vertex v : affectedList)
+        {
+            affected[v] = false;
+        }
+
+        repaired = 0;
+        while (!heap.empty())
+        {
+            Vertex v = heap.top();
+            int distance = heap.top_key();
+            heap.pop();
+            repaired ++;
+
+            graph.forEachNeighbor(v, [&](Vertex to, int weight) {
+                offer(to, v, distance + weight);
+            });
+        }
+
+        knownVersion = graph.edges.version();
+    }
+
+    template <typename E>
+    Vertex DynamicShortestPath<E>::source() const
+    {
+        return start;
+    }
+
+    template <typename E>
+    int DynamicShortestPath<E>::distance(Vertex v)
+    {
+        if (v >= graph.vertexCount)
+        {
+            throw std::out_of_range("distance: vertex out of range");
+        }
+        sync();
+        return dist[v];
+    }
+
+    template <typename E>
+    const vector<int>& DynamicShortestPath<E>::distances()
+    {
+        sync();
+        return dist;
+    }
+
+    template <typename E>
+    const vector<Vertex>& DynamicShortestPath<E>::predecessors()
+    {
+        sync();
+        return pred;
+    }
+
+    template <typename E>
+    PredecessorPath DynamicShortestPath<E>::path(Vertex to)
+    {
+        if (to >= graph.vertexCount)
+        {
+            throw std::out_of_range("path: vertex out of range");
+        }
+        sync();
+        return PredecessorPath(pred, dist, to);
+    }
+
+    template <typename E>
+    size_t DynamicShortestPath<E>::lastRepairSize() const
+    {
+        return repaired;
+    }
+}
@@ -0,0 +1,257 @@
+#pragma once
+#include "graph.h"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace DataStructure
+{
+    enum class EdgeListFormat
+    {
+        Plain,      // 每行 "from to [weight]"，缺省权值为 1，'#' 或 '%' 开头为注释，顶点从 0 编号
+        Dimacs      // DIMACS 最短路格式："p sp n m" 与 "a u v w"，'c' 开头为注释，顶点从 1 编号
+    };
+
+    // 流式的边表解析器：按块读入，在块内直接切行并用 std::from_chars 解析，不为每条边构造 std::string。
+    // 内存占用只有一个读缓冲区和一批边，文件大小不受内存限制。
+    class EdgeListParser
+    {
+    public:
+        EdgeListParser(EdgeListFormat format = EdgeListFormat::Plain, size_t chunkSize = 1 << 20);
+
+        // 每解析出 batchSize 条边调用一次 sink(const vector<Edge>&)，最后一批可能不足 batchSize
+        template <typename Sink>
+        void parseFile(const std::string& path, Sink&& sink, size_t batchSize = 1 << 16);
+        template <typename Sink>
+        void parseStream(std::istream& in, Sink&& sink, size_t batchSize = 1 << 16);
+
+        // 以下统计针对最近一次解析的输入
+        size_t vertexCount() const;     // DIMACS 取 p 行的 n，否则为出现过的最大顶点编号 + 1
+        size_t edgeCount() const;
+        size_t lineNumber() const;
+
+    private:
+        bool parseLine(const char* begin, const char* end, Edge& edge);
+        static const char* skipSpace(const char* p, const char* end);
+        template <typename T>
+        const char* parseNumber(const char* p, const char* end, T& value);
+
+    private:
+        EdgeListFormat format;
+        size_t chunkSize;
+        size_t maxVertex;
+        size_t declaredVertices;
+        size_t edges;
+        size_t lines;
+    };
+
+    inline EdgeListParser::EdgeListParser(EdgeListFormat format, size_t chunkSize)
+        : format(format), chunkSize(std::max<size_t>(chunkSize, 4096)), maxVertex(0), declaredVertices(0), edges(0), lines(0) {}
+
+    inline size_t EdgeListParser::vertexCount() const
+    {
+        if (declaredVertices != 0)
+        {
+            return declaredVertices;
+        }
+        return edges == 0 ? 0 : maxVertex + 1;
+    }
+
+    inline size_t EdgeListParser::edgeCount() const
+    {
+        return edges;
+    }
+
+    inline size_t EdgeListParser::lineNumber() const
+    {
+        return lines;
+    }
+
+    inline const char* EdgeListParser::skipSpace(const char* p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        {
+            p ++;
+        }
+        return p;
+    }
+
+    template <typename T>
+    const char* EdgeListParser::parseNumber(const char* p, const char* end, T& value)
+    {
+        p = skipSpace(p, end);
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc())
+        {
+            throw std::runtime_error("EdgeListParser: malformed number on line " + std::to_string(lines));
+        }
+        return result.ptr;
+    }
+
+    // 解析一行，是边返回 true，注释、空行和问题描述行返回 false
+    inline bool EdgeListParser::parseLine(const char* begin, const char* end, Edge& edge)
+    {
+        const char* p = skipSpace(begin, end);
+        if (p == end)
+        {
+            return false;
+        }
+
+        if (format == EdgeListFormat::Dimacs)
+        {
+            char tag = *p;
+            if (tag == 'p')
+            {
+                // "p sp n m"
+                p = skipSpace(p + 1, end);
+                while (p < end && *p != ' ' && *p != '\t')
+                {
+                    p ++;
+                }
+                size_t n = 0;
+                parseNumber(p, end, n);
+                declaredVertices = n;
+                return false;
+            }
+            if (tag != 'a')
+            {
+                return false;
+            }
+
+            size_t from = 0, to = 0;
+            p = parseNumber(p + 1, end, from);
+            p = parseNumber(p, end, to);
+            p = parseNumber(p, end, edge.weight);
+            if (from == 0 || to == 0)
+            {
+                throw std::runtime_error("EdgeListParser: DIMACS vertices start at 1, line " + std::to_string(lines));
+            }
+            edge.from = from - 1;
+            edge.to = to - 1;
+        }
+        else
+        {
+            if (*p == '#' || *p == '%')
+            {
+                return false;
+            }
+
+            p = parseNumber(p, end, edge.from);
+            p = parseNumber(p, end, edge.to);
+            p = skipSpace(p, end);
+            edge.weight = 1;
+            if (p < end)
+            {
+                p = parseNumber(p, end, edge.weight);
+            }
+        }
+
+        if (skipSpace(p, end) != end)
+        {
+            throw std::runtime_error("EdgeListParser: trailing characters on line " + std::to_string(lines));
+        }
+
+        maxVertex = std::max(maxVertex, std::max(edge.from, edge.to));
+        edges ++;
+        return true;
+    }
+
+    template <typename Sink>
+    void EdgeListParser::parseFile(const std::string& path, Sink&& sink, size_t batchSize)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("EdgeListParser: cannot open " + path);
+        }
+        parseStream(in, sink, batchSize);
+    }
+
+    template <typename Sink>
+    void EdgeListParser::parseStream(std::istream& in, Sink&& sink, size_t batchSize)
+    {
+        maxVertex = 0;
+        declaredVertices = 0;
+        edges = 0;
+        lines = 0;
+
+        vector<char> buffer(chunkSize);
+        vector<Edge> batch;
+        batch.reserve(batchSize);
+        size_t kept = 0;     // 上一块末尾不完整的行，已挪到缓冲区开头
+
+        while (true)
+        {
+            in.read(buffer.data() + kept, buffer.size() - kept);
+            size_t filled = kept + static_cast<size_t>(in.gcount());
+            bool last = filled < buffer.size();
+
+            const char* p = buffer.data();
+            const char* end = buffer.data() + filled;
+            while (true)
+            {
+                const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (newline == nullptr)
+                {
+                    if (!last) break;
+                    newline = end;     // 文件最后一行可以没有换行符
+                    if (p == end) break;
+                }
+
+                lines ++;
+                Edge edge;
+                if (parseLine(p, newline, edge))
+                {
+                    batch.push_back(edge);
+                    if (batch.size() == batchSize)
+                    {
+                        sink(static_cast<const vector<Edge>&>(batch));
+                        batch.clear();
+                    }
+                }
+                p = newline == end ? end : newline + 1;
+            }
+
+            if (last) break;
+
+            kept = end - p;
+            if (kept == buffer.size())
+            {
+                // 一行比整个缓冲区还长，扩大缓冲区
+                buffer.resize(buffer.size() * 2);
+            }
+            else
+            {
+                std::memmove(buffer.data(), p, kept);
+            }
+        }
+
+        if (!batch.empty())
+        {
+            sink(static_cast<const vector<Edge>&>(batch));
+        }
+    }
+
+    // 解析整个边表后交给 GraphType::fromEdges 批量建图（GraphList / GraphMatrix）。
+    // vertexCount 为 0 时使用文件中的顶点数。
+    template <typename GraphType>
+    GraphType loadEdgeList(const std::string& path, EdgeListFormat format = EdgeListFormat::Plain,
+                           size_t vertexCount = 0, size_t threads = 0)
+    {
+        EdgeListParser parser(format);
+        vector<Edge> edges;
+        parser.parseFile(path, [&](const vector<Edge>& batch) {
+            edges.insert(edges.end(), batch.begin(), batch.end());
+        });
+
+        if (vertexCount == 0)
+        {
+            vertexCount = parser.vertexCount();
+        }
+        return GraphType::fromEdges(vertexCount, edges, threads);
+    }
+}
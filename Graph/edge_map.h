@@ -0,0 +1,301 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace DataStructure
+{
+    using Vertex = size_t;
+
+    struct Edge
+    {
+        Vertex from;
+        Vertex to;
+        int weight;
+    };
+
+    // 以 (from, to) 为键、权值为值的开放寻址哈希表。
+    // 键打包成 64 位整数（顶点编号需小于 2^32），用 splitmix64 的混合函数打散后线性探测，
+    // 删除时把后面的元素往回挪（backward shift），不留墓碑。遍历时按 Edge 返回。
+    class EdgeMap
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Edge;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Edge*;
+            using reference = Edge;
+
+            const_iterator(const EdgeMap* map, size_t slot);
+            Edge operator*() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+            bool operator==(const const_iterator& other) const;
+            bool operator!=(const const_iterator& other) const;
+
+        private:
+            void skipEmpty();
+
+            const EdgeMap* map;
+            size_t slot;
+        };
+
+    public:
+        EdgeMap();
+
+        int* find(Vertex from, Vertex to);
+        const int* find(Vertex from, Vertex to) const;
+        bool insert(Vertex from, Vertex to, int weight);    // 已存在时不修改，返回 false
+        bool relax(Vertex from, Vertex to, int weight);     // 不存在则插入，否则取较小的权值；有变化时返回 true
+        bool erase(Vertex from, Vertex to);
+        void reserve(size_t n);
+        void clear();
+        size_t size() const;
+        bool empty() const;
+        uint64_t version() const;                           // 每次内容变化都会增加，用来判断由边集生成的缓存是否过期
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        static constexpr uint64_t emptyKey = ~uint64_t(0);  // from == to 的键，自环不会被存入
+
+        static uint64_t pack(Vertex from, Vertex to);
+        static uint64_t mix(uint64_t key);
+        size_t slotOf(uint64_t key) const;
+        size_t locate(uint64_t key) const;                  // 找到键所在的槽，或应当插入的空槽
+        void rehash(size_t capacity);
+
+        std::vector<uint64_t> keys;
+        std::vector<int> weights;
+        size_t count;
+        size_t mask;
+        uint64_t revision;
+    };
+
+    inline EdgeMap::const_iterator::const_iterator(const EdgeMap* map, size_t slot) : map(map), slot(slot)
+    {
+        skipEmpty();
+    }
+
+    inline void EdgeMap::const_iterator::skipEmpty()
+    {
+        while (slot < map -> keys.size() && map -> keys[slot] == emptyKey)
+        {
+            slot ++;
+        }
+    }
+
+    inline Edge EdgeMap::const_iterator::operator*() const
+    {
+        uint64_t key = map -> keys[slot];
+        return Edge{static_cast<Vertex>(key >> 32), static_cast<Vertex>(key & 0xffffffffu), map -> weights[slot]};
+    }
+
+    inline EdgeMap::const_iterator& EdgeMap::const_iterator::operator++()
+    {
+        slot ++;
+        skipEmpty();
+        return *this;
+    }
+
+    inline EdgeMap::const_iterator EdgeMap::const_iterator::operator++(int)
+    {
+        const_iterator old = *this;
+        ++ *this;
+        return old;
+    }
+
+    inline bool EdgeMap::const_iterator::operator==(const const_iterator& other) const
+    {
+        return slot == other.slot;
+    }
+
+    inline bool EdgeMap::const_iterator::operator!=(const const_iterator& other) const
+    {
+        return slot != other.slot;
+    }
+
+    inline EdgeMap::EdgeMap() : count(0), mask(0), revision(0) {}
+
+    inline uint64_t EdgeMap::pack(Vertex from, Vertex to)
+    {
+        return (static_cast<uint64_t>(from) << 32) | static_cast<uint32_t>(to);
+    }
+
+    inline uint64_t EdgeMap::mix(uint64_t key)
+    {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        key ^= key >> 31;
+        return key;
+    }
+
+    inline size_t EdgeMap::slotOf(uint64_t key) const
+    {
+        return mix(key) & mask;
+    }
+
+    inline size_t EdgeMap::locate(uint64_t key) const
+    {
+        size_t slot = slotOf(key);
+        while (keys[slot] != emptyKey && keys[slot] != key)
+        {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    inline int* EdgeMap::find(Vertex from, Vertex to)
+    {
+        if (count == 0) return nullptr;
+        size_t slot = locate(pack(from, to));
+        return keys[slot] == emptyKey ? nullptr : &weights[slot];
+    }
+
+    inline const int* EdgeMap::find(Vertex from, Vertex to) const
+    {
+        if (count == 0) return nullptr;
+        size_t slot = locate(pack(from, to));
+        return keys[slot] == emptyKey ? nullptr : &weights[slot];
+    }
+
+    inline bool EdgeMap::insert(Vertex from, Vertex to, int weight)
+    {
+        // 负载因子不超过 7/10
+        if ((count + 1) * 10 > keys.size() * 7)
+        {
+            rehash(keys.empty() ? 16 : keys.size() * 2);
+        }
+
+        uint64_t key = pack(from, to);
+        size_t slot = locate(key);
+        if (keys[slot] == key)
+        {
+            return false;
+        }
+        keys[slot] = key;
+        weights[slot] = weight;
+        count ++;
+        revision ++;
+        return true;
+    }
+
+    inline bool EdgeMap::relax(Vertex from, Vertex to, int weight)
+    {
+        int* known = find(from, to);
+        if (known == nullptr)
+        {
+            return insert(from, to, weight);
+        }
+        if (*known > weight)
+        {
+            *known = weight;
+            revision ++;
+            return true;
+        }
+        return false;
+    }
+
+    inline bool EdgeMap::erase(Vertex from, Vertex to)
+    {
+        if (count == 0) return false;
+
+        size_t hole = locate(pack(from, to));
+        if (keys[hole] == emptyKey)
+        {
+            return false;
+        }
+
+        // 把探测链上后面的元素挪进空位，直到遇到空槽
+        size_t next = (hole + 1) & mask;
+        while (keys[next] != emptyKey)
+        {
+            size_t home = slotOf(keys[next]);
+            // home 不在 (hole, next] 之间时，这个元素可以挪到 hole
+            if (((next - home) & mask) >= ((next - hole) & mask))
+            {
+                keys[hole] = keys[next];
+                weights[hole] = weights[next];
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+        keys[hole] = emptyKey;
+        count --;
+        revision ++;
+        return true;
+    }
+
+    inline void EdgeMap::reserve(size_t n)
+    {
+        size_t capacity = 16;
+        while (capacity * 7 < n * 10)
+        {
+            capacity *= 2;
+        }
+        if (capacity > keys.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    inline void EdgeMap::rehash(size_t capacity)
+    {
+        std::vector<uint64_t> oldKeys(capacity, emptyKey);
+        std::vector<int> oldWeights(capacity);
+        oldKeys.swap(keys);
+        oldWeights.swap(weights);
+        mask = capacity - 1;
+
+        for (size_t i = 0; i < oldKeys.size(); i ++)
+        {
+            if (oldKeys[i] != emptyKey)
+            {
+                size_t slot = locate(oldKeys[i]);
+                keys[slot] = oldKeys[i];
+                weights[slot] = oldWeights[i];
+            }
+        }
+    }
+
+    inline void EdgeMap::clear()
+    {
+        keys.clear();
+        weights.clear();
+        count = 0;
+        mask = 0;
+        revision ++;
+    }
+
+    inline size_t EdgeMap::size() const
+    {
+        return count;
+    }
+
+    inline bool EdgeMap::empty() const
+    {
+        return count == 0;
+    }
+
+    inline uint64_t EdgeMap::version() const
+    {
+        return revision;
+    }
+
+    inline EdgeMap::const_iterator EdgeMap::begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    inline EdgeMap::const_iterator EdgeMap::end() const
+    {
+        return const_iterator(this, keys.size());
+    }
+}
@@ -1,52 +1,240 @@
 #pragma once
+#include <atomic>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <set>
-#include <unordered_set>
+#include <stdexcept>
 #include <utility>
 #include <vector>
+#include "../heap/heap.h"
+#include "edge_map.h"
+#include "graph_parallel.h"
+#include "../disjoint_set/disjoint_set.h"
 
 using std::vector;
 
 namespace DataStructure
 {
-    using Vertex = size_t;
     constexpr int INF = std::numeric_limits<int>().max() / 2;
 
-    struct Edge
+    using MSTResult = std::pair<int, vector<Edge>>;
+    using PathResult = std::pair<int, vector<Vertex>>;     // (距离, 从起点到终点依次经过的顶点)
+    // Prim 选点方式：Heap 为 O(E log V)，适合稀疏图；Dense 每轮扫描全部顶点，O(V^2)，适合稠密图
+    enum class PrimStrategy
+    {
+        Heap,
+        Dense
+    };
+
+    using DistanceHeap = Da::IndexedHeap<int, std::greater<int>>;   // 以距离为键的小根堆
+
+    // 最短路的工作区，批量查询时每个线程持有一份，避免每个源点重新分配
+    struct ShortestPathScratch
+    {
+        ShortestPathScratch(size_t vertexCount) : heap(vertexCount), visited(vertexCount, false) {}
+
+        DistanceHeap heap;
+        vector<bool> visited;
+        vector<Vertex> queue;       // 以下只给 spfa / Bellman_Ford 用，第一次用到时才分配
+        vector<int> hops;
+        vector<int> last;
+    };
+
+    // 由边集生成的 CSR 邻接，reverse 为 true 时存的是入边（targets 为边的起点）
+    struct AdjacencyIndex
     {
-        Vertex from;
-        Vertex to;
-        int weight;
+        void build(size_t vertexCount, const EdgeMap& edges, bool reverse);
+
+        vector<size_t> offsets;
+        vector<Vertex> targets;
+        vector<int> weights;
     };
 
-    //处理
-    struct EdgeHash
+    inline void AdjacencyIndex::build(size_t vertexCount, const EdgeMap& edges, bool reverse)
     {
-        size_t operator()(const Edge& e) const
+        offsets.assign(vertexCount + 1, 0);
+        for (const auto& e : edges)
+        {
+            offsets[(reverse ? e.to : e.from) + 1] ++;
+        }
+        for (Vertex v = 0; v < vertexCount; v ++)
         {
-            return std::hash<Vertex>()(e.from) ^ std::hash<Vertex>()(e.to);
+            offsets[v + 1] += offsets[v];
         }
+
+        targets.resize(edges.size());
+        weights.resize(edges.size());
+        vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        for (const auto& e : edges)
+        {
+            size_t pos = next[reverse ? e.to : e.from] ++;
+            targets[pos] = reverse ? e.from : e.to;
+            weights[pos] = e.weight;
+        }
+    }
+
+    // 双向 Dijkstra 的工作区，下标 0 为正向搜索，1 为反向搜索。
+    // 距离数组只在 touched 记录的顶点上复原，一次查询的开销与搜索到的顶点数成正比。
+    struct BidirectionalScratch
+    {
+        void resize(size_t vertexCount);
+
+        DistanceHeap heap[2];
+        vector<int> dist[2];
+        vector<Vertex> parent[2];
+        vector<bool> settled[2];
+        vector<Vertex> touched;
     };
 
-    struct EdgeEqual
+    inline void BidirectionalScratch::resize(size_t vertexCount)
     {
-        bool operator()(const Edge& e1, const Edge& e2) const
+        for (int side = 0; side < 2; side ++)
         {
-            return e1.from == e2.from && e1.to == e2.to;
+            heap[side].resize(vertexCount);
+            dist[side].assign(vertexCount, INF);
+            parent[side].assign(vertexCount, vertexCount);
+            settled[side].assign(vertexCount, false);
         }
+        touched.clear();
+    }
+
+    // 行主序的连续距离矩阵，第 i 行是第 i 个源点到所有顶点的距离
+    class DistanceMatrix
+    {
+    public:
+        DistanceMatrix(size_t rows = 0, size_t cols = 0, int value = INF);
+
+        size_t rows() const;
+        size_t cols() const;
+        int* row(size_t i);
+        const int* row(size_t i) const;
+        int& operator()(size_t i, size_t j);
+        int operator()(size_t i, size_t j) const;
+        int* data();
+        const int* data() const;
+
+    private:
+        size_t rowCount;
+        size_t colCount;
+        vector<int> values;
     };
 
-    using MSTResult = std::pair<int, vector<Edge>>;
+    inline DistanceMatrix::DistanceMatrix(size_t rows, size_t cols, int value)
+        : rowCount(rows), colCount(cols), values(rows * cols, value) {}
+
+    inline size_t DistanceMatrix::rows() const
+    {
+        return rowCount;
+    }
+
+    inline size_t DistanceMatrix::cols() const
+    {
+        return colCount;
+    }
+
+    inline int* DistanceMatrix::row(size_t i)
+    {
+        return values.data() + i * colCount;
+    }
+
+    inline const int* DistanceMatrix::row(size_t i) const
+    {
+        return values.data() + i * colCount;
+    }
+
+    inline int& DistanceMatrix::operator()(size_t i, size_t j)
+    {
+        return values[i * colCount + j];
+    }
+
+    inline int DistanceMatrix::operator()(size_t i, size_t j) const
+    {
+        return values[i * colCount + j];
+    }
+
+    inline int* DistanceMatrix::data()
+    {
+        return values.data();
+    }
+
+    inline const int* DistanceMatrix::data() const
+    {
+        return values.data();
+    }
+
+    // 按起点对边做稳定的并行计数排序，自环会被丢掉。
+    // 结束后起点为 v 的边位于 sorted[offsets[v], offsets[v + 1])，并保持输入中的相对顺序。
+    // 每个线程各有一份长度为 vertexCount 的计数，线程数因此限制在 边数 / 顶点数 以内。
+    inline void sortEdgesBySource(size_t vertexCount, const vector<Edge>& edges, vector<size_t>& offsets,
+                                  vector<Edge>& sorted, size_t threads = 0)
+    {
+        size_t workers = parallelWorkers(edges.size(), threads, 1 << 16);
+        workers = std::max<size_t>(1, std::min(workers, edges.size() / std::max<size_t>(1, vertexCount)));
+
+        auto chunkBegin = [&](size_t c) { return edges.size() * c / workers; };
+
+        vector<vector<size_t>> counts(workers, vector<size_t>(vertexCount, 0));
+        parallelRange(workers, workers, 1, [&](size_t, size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c ++)
+            {
+                for (size_t i = chunkBegin(c); i < chunkBegin(c + 1); i ++)
+                {
+                    if (edges[i].from != edges[i].to)
+                    {
+                        counts[c][edges[i].from] ++;
+                    }
+                }
+            }
+        });
+
+        // 把计数改成每个线程在每个起点下的写入位置
+        offsets.assign(vertexCount + 1, 0);
+        size_t total = 0;
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            offsets[v] = total;
+            for (size_t c = 0; c < workers; c ++)
+            {
+                size_t count = counts[c][v];
+                counts[c][v] = total;
+                total += count;
+            }
+        }
+        offsets[vertexCount] = total;
+
+        sorted.resize(total);
+        parallelRange(workers, workers, 1, [&](size_t, size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c ++)
+            {
+                for (size_t i = chunkBegin(c); i < chunkBegin(c + 1); i ++)
+                {
+                    if (edges[i].from != edges[i].to)
+                    {
+                        sorted[counts[c][edges[i].from] ++] = edges[i];
+                    }
+                }
+            }
+        });
+    }
+
+    class ContractionHierarchy;
 
     template <typename E>
     class Graph
     {
+        friend class ContractionHierarchy;
+
     public:
         Graph(size_t vertexCount) : vertexCount(vertexCount)
         {
+            if (vertexCount >= (uint64_t(1) << 32))
+            {
+                throw std::length_error("Graph: vertex count must fit in 32 bits");
+            }
             vertices.resize(vertexCount);
         }
         virtual void addEdge(Vertex from, Vertex to, int weight = 1) = 0;
@@ -64,17 +252,428 @@ namespace DataStructure
         virtual bool containsNegativeCycle() = 0;
         virtual MSTResult Prim() = 0;
         virtual MSTResult Kruskal() = 0;
+        // 并行 delta-stepping，边权需非负；delta 为 0 时自动选取
+        virtual vector<int> DeltaStepping(Vertex start, int delta = 0, size_t threads = 0) = 0;
+
+        // 对 sources 中每个源点跑 Dijkstra，结果第 i 行对应 sources[i]。
+        // 各线程复用自己的工作区；调用期间不能修改图。
+        DistanceMatrix DijkstraMany(const vector<Vertex>& sources, size_t threads = 0);
+        // 把边集展开成数组后分段并行松弛，距离用原子 min 更新，某一轮没有松弛就提前结束。
+        // steps 为 -1 时原地更新（收敛更快）；指定 steps 时每轮只用上一轮的距离，语义与 Bellman_Ford 相同。
+        // 不可达的顶点不参与松弛，距离保持 INF。
+        vector<int> ParallelBellmanFord(Vertex start, int steps = -1, size_t threads = 0);
+        // Filter-Kruskal：按枢轴权值划分边集，先处理轻的一半，再滤掉两端已连通的重边后递归；
+        // 小规模的子问题并行排序后直接做 Kruskal。结果与 Kruskal 相同。
+        MSTResult FilterKruskal(size_t threads = 0);
+        // Boruvka：每轮并行地为每个连通块找最便宜的出边，全部加入后收缩连通块，最多 log V 轮
+        MSTResult Boruvka(size_t threads = 0);
+        // 双向 Dijkstra 求 from 到 to 的最短路，边权需非负，两侧堆顶之和不小于已知最短路时结束。
+        // 不可达时返回 (INF, {})。正反两份邻接在第一次查询或边集变化后重建，
+        // 之后的查询复用它们和工作区，所以不能并发调用。
+        PathResult shortestPath(Vertex from, Vertex to);
 
     public:
         void setVertex(Vertex vertex, E value);
         E getVertex(Vertex vertex);
         
+    protected:
+        void FilterKruskal(vector<Edge>& edgeList, size_t begin, size_t end, DisjointSet& set,
+                           MSTResult& result, size_t threads);
+        // edges 变化后重建 edgeIndex，之后直到下次修改前都直接复用
+        void refreshEdgeIndex();
+        // 沿 edgeIndex[1] 遍历 v 的入边，visit(from, weight) 返回 true 时提前结束。调用前需先 refreshEdgeIndex
+        template <typename F>
+        void forEachPredecessor(Vertex v, F&& visit) const;
+
+    protected:
+        // 把 start 出发的最短距离写入 ans[0, vertexCount)，只读访问图，可被多个线程同时调用
+        virtual void DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch) = 0;
+
     protected:
         size_t vertexCount;
         std::vector<E> vertices;
-        std::unordered_set<Edge, EdgeHash, EdgeEqual> edges;
+        EdgeMap edges;      // 每对 (from, to) 只记一条边，权值取最小
+        AdjacencyIndex edgeIndex[2];                // 由 edges 生成的正向、反向邻接，用 refreshEdgeIndex 更新
+        bool negativeWeights = false;               // edgeIndex 中是否有负权边
+
+    private:
+        uint64_t edgeIndexVersion = ~uint64_t(0);   // 建立 edgeIndex 时 edges 的版本
+        BidirectionalScratch pathScratch;
     };
 
+    template <typename E>
+    DistanceMatrix Graph<E>::DijkstraMany(const vector<Vertex>& sources, size_t threads)
+    {
+        for (Vertex source : sources)
+        {
+            if (source >= this -> vertexCount)
+            {
+                throw std::out_of_range("DijkstraMany: source vertex out of range");
+            }
+        }
+
+        DistanceMatrix ans(sources.size(), this -> vertexCount);
+
+        size_t workers = parallelWorkers(sources.size(), threads);
+        vector<ShortestPathScratch> scratch(workers, ShortestPathScratch(this -> vertexCount));
+
+        parallelRange(sources.size(), workers, 1, [&](size_t worker, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i ++)
+            {
+                DijkstraInto(sources[i], ans.row(i), scratch[worker]);
+            }
+        });
+
+        return ans;
+    }
+
+    template <typename E>
+    vector<int> Graph<E>::ParallelBellmanFord(Vertex start, int steps, size_t threads)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("ParallelBellmanFord: start vertex out of range");
+        }
+
+        const vector<Edge> edgeList(this -> edges.begin(), this -> edges.end());
+        vector<std::atomic<int>> dist(this -> vertexCount);
+        for (auto& d : dist)
+        {
+            d.store(INF, std::memory_order_relaxed);
+        }
+        dist[start].store(0, std::memory_order_relaxed);
+
+        const bool snapshot = steps != -1;
+        vector<int> last(snapshot ? this -> vertexCount : 0);
+        if (steps == -1) steps = this -> vertexCount - 1;
+
+        for (int i = 0; i < steps; ++ i)
+        {
+            if (snapshot)
+            {
+                for (Vertex v = 0; v < this -> vertexCount; v ++)
+                {
+                    last[v] = dist[v].load(std::memory_order_relaxed);
+                }
+            }
+
+            std::atomic<bool> relaxed(false);
+            parallelRange(edgeList.size(), threads, 1 << 14, [&](size_t, size_t begin, size_t end) {
+                bool local = false;
+                for (size_t j = begin; j < end; j ++)
+                {
+                    const Edge& e = edgeList[j];
+                    int from = snapshot ? last[e.from] : dist[e.from].load(std::memory_order_relaxed);
+                    if (from != INF && atomicMin(dist[e.to], from + e.weight))
+                    {
+                        local = true;
+                    }
+                }
+                if (local)
+                {
+                    relaxed.store(true, std::memory_order_relaxed);
+                }
+            });
+
+            if (!relaxed.load(std::memory_order_relaxed)) break;
+        }
+
+        vector<int> ans(this -> vertexCount);
+        for (Vertex v = 0; v < this -> vertexCount; v ++)
+        {
+            ans[v] = dist[v].load(std::memory_order_relaxed);
+        }
+        return ans;
+    }
+
+    template <typename E>
+    MSTResult Graph<E>::FilterKruskal(size_t threads)
+    {
+        vector<Edge> edgeList(this -> edges.begin(), this -> edges.end());
+        DisjointSet set(this -> vertexCount);
+        MSTResult result(0, vector<Edge>());
+        result.second.reserve(this -> vertexCount);
+
+        FilterKruskal(edgeList, 0, edgeList.size(), set, result, threads);
+
+        if (result.second.size() + 1 != this -> vertexCount)
+        {
+            return std::make_pair(-1, vector<Edge>());
+        }
+        return result;
+    }
+
+    template <typename E>
+    void Graph<E>::FilterKruskal(vector<Edge>& edgeList, size_t begin, size_t end, DisjointSet& set,
+                                 MSTResult& result, size_t threads)
+    {
+        constexpr size_t baseCase = 1 << 16;
+        if (begin >= end || set.count() == 1) return;
+
+        auto lighter = [](const Edge& a, const Edge& b) {
+            return a.weight < b.weight;
+        };
+
+        auto first = edgeList.begin() + begin;
+        auto last = edgeList.begin() + end;
+
+        int lo = first -> weight, hi = first -> weight;
+        for (auto it = first; it != last; ++ it)
+        {
+            lo = std::min(lo, it -> weight);
+            hi = std::max(hi, it -> weight);
+        }
+
+        if (end - begin <= baseCase || lo == hi)
+        {
+            parallelSort(first, last, lighter, threads);
+            for (auto it = first; it != last && set.count() > 1; ++ it)
+            {
+                if (set.unite(it -> from, it -> to))
+                {
+                    result.first += it -> weight;
+                    result.second.emplace_back(*it);
+                }
+            }
+            return;
+        }
+
+        // 取首、中、尾三个权值的中位数作枢轴，且保证轻的一半非空、重的一半非空
+        int a = first -> weight, b = (first + (end - begin) / 2) -> weight, c = (last - 1) -> weight;
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        if (pivot == hi) pivot = hi - 1;
+
+        auto middle = std::partition(first, last, [pivot](const Edge& e) {
+            return e.weight <= pivot;
+        });
+        size_t split = middle - edgeList.begin();
+
+        FilterKruskal(edgeList, begin, split, set, result, threads);
+
+        // 重的一半里两端已经连通的边不可能进入 MST，先滤掉
+        auto kept = std::partition(middle, last, [&set](const Edge& e) {
+            return set.find(e.from) != set.find(e.to);
+        });
+        FilterKruskal(edgeList, split, kept - edgeList.begin(), set, result, threads);
+    }
+
+    template <typename E>
+    MSTResult Graph<E>::Boruvka(size_t threads)
+    {
+        const vector<Edge> edgeList(this -> edges.begin(), this -> edges.end());
+        if (edgeList.size() >= (uint64_t(1) << 32))
+        {
+            throw std::length_error("Boruvka: too many edges");
+        }
+
+        // 候选边编码成 (权值, 边号) 的 64 位整数，权值相同时按边号区分，保证各块选出的边不成环
+        constexpr uint64_t none = std::numeric_limits<uint64_t>::max();
+        auto encode = [&](size_t index) {
+            uint64_t weight = static_cast<uint32_t>(edgeList[index].weight) ^ 0x80000000u;
+            return (weight << 32) | index;
+        };
+        auto atomicMinKey = [](std::atomic<uint64_t>& target, uint64_t value) {
+            uint64_t old = target.load(std::memory_order_relaxed);
+            while (value < old && !target.compare_exchange_weak(old, value, std::memory_order_relaxed));
+        };
+
+        DisjointSet set(this -> vertexCount);
+        vector<Vertex> component(this -> vertexCount);
+        for (Vertex v = 0; v < this -> vertexCount; v ++)
+        {
+            component[v] = v;
+        }
+        vector<std::atomic<uint64_t>> cheapest(this -> vertexCount);
+        vector<size_t> alive(edgeList.size());
+        for (size_t i = 0; i < alive.size(); i ++)
+        {
+            alive[i] = i;
+        }
+
+        vector<Edge> MSTedges;
+        int edgeSum = 0;
+
+        while (set.count() > 1 && !alive.empty())
+        {
+            for (auto& c : cheapest)
+            {
+                c.store(none, std::memory_order_relaxed);
+            }
+
+            parallelRange(alive.size(), threads, 1 << 14, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i ++)
+                {
+                    const Edge& e = edgeList[alive[i]];
+                    Vertex a = component[e.from], b = component[e.to];
+                    if (a != b)
+                    {
+                        uint64_t key = encode(alive[i]);
+                        atomicMinKey(cheapest[a], key);
+                        atomicMinKey(cheapest[b], key);
+                    }
+                }
+            });
+
+            bool merged = false;
+            for (Vertex c = 0; c < this -> vertexCount; c ++)
+            {
+                uint64_t key = cheapest[c].load(std::memory_order_relaxed);
+                if (key == none) continue;
+
+                const Edge& e = edgeList[key & 0xffffffffu];
+                if (set.unite(e.from, e.to))
+                {
+                    MSTedges.emplace_back(e);
+                    edgeSum += e.weight;
+                    merged = true;
+                }
+            }
+            if (!merged) break;
+
+            // 收缩：每个顶点改记所在块的代表元，再丢掉两端已在同一块的边
+            const DisjointSet& frozen = set;
+            parallelRange(this -> vertexCount, threads, 1 << 14, [&](size_t, size_t begin, size_t end) {
+                for (Vertex v = begin; v < end; v ++)
+                {
+                    component[v] = frozen.find(v);
+                }
+            });
+            alive.erase(std::remove_if(alive.begin(), alive.end(), [&](size_t i) {
+                return component[edgeList[i].from] == component[edgeList[i].to];
+            }), alive.end());
+        }
+
+        if (MSTedges.size() + 1 != this -> vertexCount)
+        {
+            return std::make_pair(-1, vector<Edge>());
+        }
+        return std::make_pair(edgeSum, std::move(MSTedges));
+    }
+
+    template <typename E>
+    void Graph<E>::refreshEdgeIndex()
+    {
+        if (edgeIndexVersion == this -> edges.version())
+        {
+            return;
+        }
+
+        negativeWeights = false;
+        for (const auto& e : this -> edges)
+        {
+            negativeWeights = negativeWeights || e.weight < 0;
+        }
+
+        edgeIndex[0].build(this -> vertexCount, this -> edges, false);
+        edgeIndex[1].build(this -> vertexCount, this -> edges, true);
+        pathScratch.resize(this -> vertexCount);
+        edgeIndexVersion = this -> edges.version();
+    }
+
+    template <typename E>
+    template <typename F>
+    void Graph<E>::forEachPredecessor(Vertex v, F&& visit) const
+    {
+        const AdjacencyIndex& reverse = edgeIndex[1];
+        for (size_t i = reverse.offsets[v]; i < reverse.offsets[v + 1]; i ++)
+        {
+            if (visit(reverse.targets[i], reverse.weights[i])) return;
+        }
+    }
+
+    template <typename E>
+    PathResult Graph<E>::shortestPath(Vertex from, Vertex to)
+    {
+        if (from >= this -> vertexCount || to >= this -> vertexCount)
+        {
+            throw std::out_of_range("shortestPath: Vertex out of range");
+        }
+        refreshEdgeIndex();
+        if (negativeWeights)
+        {
+            throw std::runtime_error("shortestPath: negative edge weight");
+        }
+
+        BidirectionalScratch& s = pathScratch;
+        const Vertex none = this -> vertexCount;
+        int best = INF;
+        Vertex meet = none;
+
+        auto reach = [&](int side, Vertex v, int distance, Vertex parent) {
+            if (s.dist[0][v] == INF && s.dist[1][v] == INF)
+            {
+                s.touched.push_back(v);
+            }
+            s.dist[side][v] = distance;
+            s.parent[side][v] = parent;
+            s.heap[side].push_or_decrease(v, distance);
+
+            if (s.dist[1 - side][v] != INF && distance + s.dist[1 - side][v] < best)
+            {
+                best = distance + s.dist[1 - side][v];
+                meet = v;
+            }
+        };
+
+        reach(0, from, 0, none);
+        reach(1, to, 0, none);
+
+        while (!s.heap[0].empty() && !s.heap[1].empty())
+        {
+            // 此后任何经过未确定顶点的路径都不短于两侧堆顶之和
+            if (s.heap[0].top_key() + s.heap[1].top_key() >= best)
+            {
+                break;
+            }
+
+            // 扩展堆较小的一侧，两侧的搜索空间大致平衡
+            int side = s.heap[0].size() <= s.heap[1].size() ? 0 : 1;
+            Vertex v = s.heap[side].top();
+            int distance = s.heap[side].top_key();
+            s.heap[side].pop();
+            s.settled[side][v] = true;
+
+            const AdjacencyIndex& index = edgeIndex[side];
+            for (size_t i = index.offsets[v]; i < index.offsets[v + 1]; i ++)
+            {
+                Vertex next = index.targets[i];
+                if (!s.settled[side][next] && distance + index.weights[i] < s.dist[side][next])
+                {
+                    reach(side, next, distance + index.weights[i], v);
+                }
+            }
+        }
+
+        vector<Vertex> path;
+        if (meet != none)
+        {
+            for (Vertex v = meet; v != none; v = s.parent[0][v])
+            {
+                path.push_back(v);
+            }
+            std::reverse(path.begin(), path.end());
+            for (Vertex v = s.parent[1][meet]; v != none; v = s.parent[1][v])
+            {
+                path.push_back(v);
+            }
+        }
+
+        for (Vertex v : s.touched)
+        {
+            for (int side = 0; side < 2; side ++)
+            {
+                s.dist[side][v] = INF;
+                s.parent[side][v] = none;
+                s.settled[side][v] = false;
+            }
+        }
+        s.touched.clear();
+        s.heap[0].clear();
+        s.heap[1].clear();
+
+        return std::make_pair(best, std::move(path));
+    }
+
     template <typename E>
     E Graph<E>::getVertex(Vertex vertex)
     {
@@ -0,0 +1,565 @@
+#pragma once
+#include "graph.h"
+#include "bfs.h"
+#include "components.h"
+#include "delta_stepping.h"
+#include "negative_cycle.h"
+#include "spfa.h"
+#include "shortest_path_tree.h"
+#include "graph_file.h"
+#include "graph_list.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace DataStructure
+{
+    template <typename E>
+    class SnapshotGraph;
+
+    // 压缩稀疏行(CSR)存储：顶点 v 的出边位于 [offsets[v], offsets[v + 1])，
+    // targets / weights 连续存放，遍历邻接边不再追指针。
+    // 结构在构造后冻结，需要修改时在 GraphList 上改完再重新构造。
+    template <typename E>
+    class GraphCSR : public Graph<E>
+    {
+        friend class SnapshotGraph<E>;
+
+    public:
+        GraphCSR(const GraphList<E>& graph);
+        ~GraphCSR() = default;
+        virtual void addEdge(Vertex from, Vertex to, int weight = 1) override;
+        virtual void removeEdge(Vertex from, Vertex to) override;
+        virtual void printGraph() override;
+        virtual vector<Vertex> getAdjacentVertices(Vertex vertex) override;
+        void writeBinary(const std::string& path);         // 写成可 mmap 的二进制图文件，见 graph_file.h
+        virtual int getEdge(Vertex from, Vertex to) override;
+
+        size_t edgeCount() const;
+
+
+        virtual vector<int> Dijkstra(Vertex start) override;
+        virtual vector<int> Bellman_Ford(Vertex start, int steps = -1) override;
+        virtual vector<int> spfa(Vertex start) override;
+        vector<int> spfa(Vertex start, SpfaQueue strategy, size_t maxPops = 0);
+        // 同时填写前驱数组的版本，dist / pred / scratch 由调用方提供、可以反复使用，见 shortest_path_tree.h
+        void Dijkstra(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch);
+        void Bellman_Ford(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch, int steps = -1);
+        void spfa(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch);
+        virtual bool containsNegativeCycle() override;
+        // 返回一个负权环上的顶点（依次相连，最后一个连回第一个），没有时返回空数组。
+        // 边数较多时按边并行松弛，否则用 Tarjan 子树拆解，见 negative_cycle.h
+        vector<Vertex> FindNegativeCycle(size_t threads = 0);
+        virtual MSTResult Prim() override;
+        virtual MSTResult Kruskal() override;
+        virtual vector<int> DeltaStepping(Vertex start, int delta = 0, size_t threads = 0) override;
+        // 忽略边权的 BFS，返回边数，不可达为 INF。方向优化版本在前沿变大时改为自底向上，需要反向邻接（见 refreshEdgeIndex）；
+        // MultiSourceBFS 每遍同时处理 64 个源点，结果第 i 行对应 sources[i]
+        vector<int> BFS(Vertex start);
+        vector<int> DirectionOptimizingBFS(Vertex start);
+        DistanceMatrix MultiSourceBFS(const vector<Vertex>& sources);
+        // 连通分量，结果为 (分量数, 每个顶点的分量编号)：WeakComponents 忽略边的方向；
+        // StrongComponents 为非递归 Tarjan，编号按逆拓扑序；ParallelStrongComponents 为并行 forward-backward
+        ComponentResult WeakComponents(size_t threads = 0);
+        ComponentResult StrongComponents();
+        ComponentResult ParallelStrongComponents(size_t threads = 0);
+    protected:
+        virtual void DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch) override;
+
+    private:
+        template <typename F>
+        void forEachNeighbor(Vertex v, F&& func);
+
+    private:
+        vector<size_t> offsets;     // 长度 vertexCount + 1
+        vector<Vertex> targets;
+        vector<int> weights;
+    };
+
+    template <typename E>
+    GraphCSR<E>::GraphCSR(const GraphList<E>& graph) : Graph<E>(graph.vertexCount)
+    {
+        this -> vertices = graph.vertices;
+        this -> edges = graph.edges;
+
+        offsets.assign(this -> vertexCount + 1, 0);
+        for (Vertex i = 0; i < this -> vertexCount; i ++)
+        {
+            offsets[i + 1] = offsets[i] + std::distance(graph.adjList[i].begin(), graph.adjList[i].end());
+        }
+
+        targets.resize(offsets[this -> vertexCount]);
+        weights.resize(offsets[this -> vertexCount]);
+
+        for (Vertex i = 0; i < this -> vertexCount; i ++)
+        {
+            size_t pos = offsets[i];
+            for (const auto& edge : graph.adjList[i])
+            {
+                targets[pos] = edge.first;
+                weights[pos] = edge.second;
+                pos ++;
+            }
+        }
+    }
+
+    template <typename E>
+    void GraphCSR<E>::addEdge(Vertex from, Vertex to, int weight)
+    {
+        throw std::logic_error("addEdge: GraphCSR is read-only, modify the GraphList and rebuild");
+    }
+
+    template <typename E>
+    void GraphCSR<E>::removeEdge(Vertex from, Vertex to)
+    {
+        throw std::logic_error("removeEdge: GraphCSR is read-only, modify the GraphList and rebuild");
+    }
+
+    template <typename E>
+    size_t GraphCSR<E>::edgeCount() const
+    {
+        return targets.size();
+    }
+
+    template <typename E>
+    template <typename F>
+    void GraphCSR<E>::forEachNeighbor(Vertex v, F&& func)
+    {
+        for (size_t i = offsets[v]; i < offsets[v + 1]; i ++)
+        {
+            func(targets[i], weights[i]);
+        }
+    }
+
+    template <typename E>
+    vector<Vertex> GraphCSR<E>::getAdjacentVertices(Vertex vertex)
+    {
+        if (vertex >= this -> vertexCount)
+        {
+            throw std::out_of_range("getAdjacentVertices: Vertex out of range");
+        }
+        return vector<Vertex>(targets.begin() + offsets[vertex], targets.begin() + offsets[vertex + 1]);
+    }
+
+    template <typename E>
+    int GraphCSR<E>::getEdge(Vertex from, Vertex to)
+    {
+        if (from >= this -> vertexCount || to >= this -> vertexCount)
+        {
+            throw std::out_of_range("getEdge: Vertex out of range");
+        }
+        for (size_t i = offsets[from]; i < offsets[from + 1]; i ++)
+        {
+            if (targets[i] == to)
+            {
+                return weights[i];
+            }
+        }
+
+        return -1;
+    }
+
+    template <typename E>
+    void GraphCSR<E>::printGraph()
+    {
+        for (Vertex i = 0; i < this -> vertexCount; i ++)
+        {
+            std::cout << i << ": ";
+            for (size_t j = offsets[i]; j < offsets[i + 1]; j ++)
+            {
+                std::cout << "(" << targets[j] << ", " << weights[j] << ") ";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::Dijkstra(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("Dijkstra: start vertex is out of range");
+        }
+
+        vector<int> ans(this -> vertexCount);
+        ShortestPathScratch scratch(this -> vertexCount);
+        DijkstraInto(start, ans.data(), scratch);
+        return ans;
+    }
+
+    template <typename E>
+    void GraphCSR<E>::DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch)
+    {
+        DistanceHeap& heap = scratch.heap;
+        vector<bool>& visited = scratch.visited;
+
+        std::fill(ans, ans + this -> vertexCount, INF);
+        visited.assign(this -> vertexCount, false);
+
+        ans[start] = 0;
+        heap.push(start, 0);
+
+        while (!heap.empty())
+        {
+            Vertex nearNode = heap.top();
+            int distance = heap.top_key();
+            heap.pop();
+
+            visited[nearNode] = true;
+
+            for (size_t i = offsets[nearNode]; i < offsets[nearNode + 1]; i ++)
+            {
+                Vertex to = targets[i];
+                if (!visited[to] && ans[to] > distance + weights[i])
+                {
+                    ans[to] = distance + weights[i];
+                    heap.push_or_decrease(to, ans[to]);
+                }
+            }
+        }
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::Bellman_Ford(Vertex start, int steps)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("Bellman-ford: start vertex is out of range");
+        }
+        vector<int> ans(this -> vertexCount, INF);
+        vector<int> last(this -> vertexCount);
+        ans[start] = 0;
+
+        if (steps == -1) steps = this -> vertexCount - 1;
+
+        for (int i = 0; i < steps; ++ i)
+        {
+            std::copy(ans.begin(), ans.end(), last.begin());
+            bool relaxed = false;
+
+            for (Vertex u = 0; u < this -> vertexCount; u ++)
+            {
+                if (last[u] == INF) continue;
+
+                for (size_t j = offsets[u]; j < offsets[u + 1]; j ++)
+                {
+                    if (ans[targets[j]] > last[u] + weights[j])
+                    {
+                        ans[targets[j]] = last[u] + weights[j];
+                        relaxed = true;
+                    }
+                }
+            }
+
+            if (!relaxed) break; // 本轮没有松弛，之后也不会再变化
+        }
+
+        return ans;
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::spfa(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("spfa: start vertex is out of range");
+        }
+
+        vector<int> ans(this -> vertexCount, INF);
+        vector<bool> inQueue(this -> vertexCount, false);
+        std::queue<Vertex> q;
+
+        ans[start] = 0;
+        q.push(start);
+        inQueue[start] = true;
+
+        while (!q.empty())
+        {
+            Vertex v = q.front();
+            q.pop();
+            inQueue[v] = false;
+
+            for (size_t i = offsets[v]; i < offsets[v + 1]; i ++)
+            {
+                Vertex to = targets[i];
+
+                if (ans[to] > ans[v] + weights[i])
+                {
+                    ans[to] = ans[v] + weights[i];
+                    if (!inQueue[to])
+                    {
+                        inQueue[to] = true;
+                        q.push(to);
+                    }
+                }
+            }
+        }
+
+        return ans;
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::spfa(Vertex start, SpfaQueue strategy, size_t maxPops)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("spfa: start vertex is out of range");
+        }
+
+        return spfaWithQueue(this -> vertexCount, start, strategy, maxPops, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphCSR<E>::Dijkstra(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("Dijkstra: start vertex is out of range");
+        }
+
+        dijkstraTree(this -> vertexCount, start, dist, pred, scratch, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphCSR<E>::Bellman_Ford(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch, int steps)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("Bellman-ford: start vertex is out of range");
+        }
+
+        bellmanFordTree(this -> vertexCount, start, steps, this -> edges, dist, pred, scratch);
+    }
+
+    template <typename E>
+    void GraphCSR<E>::spfa(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("spfa: start vertex is out of range");
+        }
+
+        spfaTree(this -> vertexCount, start, dist, pred, scratch, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    bool GraphCSR<E>::containsNegativeCycle()
+    {
+        return !FindNegativeCycle().empty();
+    }
+
+    template <typename E>
+    vector<Vertex> GraphCSR<E>::FindNegativeCycle(size_t threads)
+    {
+        if (this -> edges.size() >= NegativeCycleParallelThreshold &&
+            parallelWorkers(this -> edges.size(), threads, 1 << 14) > 1)
+        {
+            const vector<Edge> edgeList(this -> edges.begin(), this -> edges.end());
+            return findNegativeCycleParallel(this -> vertexCount, edgeList, threads);
+        }
+
+        return findNegativeCycle(this -> vertexCount, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    MSTResult GraphCSR<E>::Prim()
+    {
+        DistanceHeap heap(this -> vertexCount);
+
+        vector<int> distences(this -> vertexCount, INF);
+        vector<Vertex> pre(this -> vertexCount, 0);
+        vector<bool> inMST(this -> vertexCount, false);
+        vector<Edge> MSTedges;
+        int edgeSum = 0;
+        size_t count = 0;
+
+        if (this -> vertexCount == 0)
+        {
+            return std::make_pair(0, vector<Edge>());
+        }
+
+        distences[0] = 0;
+        heap.push(0, 0);
+
+        while (!heap.empty())
+        {
+            Vertex nearNode = heap.top();
+            heap.pop();
+
+            inMST[nearNode] = true;
+            count ++;
+            if (nearNode != 0)
+            {
+                MSTedges.emplace_back(Edge{pre[nearNode], nearNode, distences[nearNode]});
+                edgeSum += distences[nearNode];
+            }
+
+            for (size_t i = offsets[nearNode]; i < offsets[nearNode + 1]; i ++)
+            {
+                Vertex j = targets[i];
+                if (!inMST[j] && weights[i] < distences[j])
+                {
+                    distences[j] = weights[i];
+                    pre[j] = nearNode;
+                    heap.push_or_decrease(j, weights[i]);
+                }
+            }
+        }
+
+        if (count != this -> vertexCount)
+        {
+            return std::make_pair(-1, vector<Edge>()); // 不存在MST
+        }
+
+        return std::make_pair(edgeSum, std::move(MSTedges));
+    }
+
+    template <typename E>
+    MSTResult GraphCSR<E>::Kruskal()
+    {
+        vector<Edge> MSTedges;
+        int edgeSum = 0;
+        DisjointSet set(this -> vertexCount);
+
+        vector<Edge> edges;
+        edges.reserve(targets.size());
+        for (Vertex u = 0; u < this -> vertexCount; u ++)
+        {
+            for (size_t i = offsets[u]; i < offsets[u + 1]; i ++)
+            {
+                edges.emplace_back(Edge{u, targets[i], weights[i]});
+            }
+        }
+
+        std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+            return a.weight < b.weight;
+        });
+
+        for (const auto& edge : edges)
+        {
+            if (set.unite(edge.from, edge.to))
+            {
+                MSTedges.emplace_back(edge);
+                edgeSum += edge.weight;
+            }
+        }
+
+        if (MSTedges.size() + 1 != this -> vertexCount)
+        {
+            return std::make_pair(-1, vector<Edge>());
+        }
+
+        return std::make_pair(edgeSum, std::move(MSTedges));
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::DeltaStepping(Vertex start, int delta, size_t threads)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("DeltaStepping: start vertex is out of range");
+        }
+
+        return deltaStepping(this -> vertexCount, start, delta, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::BFS(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("BFS: start vertex is out of range");
+        }
+
+        return breadthFirst(this -> vertexCount, start, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    vector<int> GraphCSR<E>::DirectionOptimizingBFS(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("DirectionOptimizingBFS: start vertex is out of range");
+        }
+
+        this -> refreshEdgeIndex();
+        const AdjacencyIndex& forward = this -> edgeIndex[0];
+
+        auto predecessors = [this](Vertex v, auto&& visit) {
+            this -> forEachPredecessor(v, visit);
+        };
+        auto degree = [&forward](Vertex v) {
+            return forward.offsets[v + 1] - forward.offsets[v];
+        };
+
+        return directionOptimizingBfs(this -> vertexCount, start, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, predecessors, degree);
+    }
+
+    template <typename E>
+    DistanceMatrix GraphCSR<E>::MultiSourceBFS(const vector<Vertex>& sources)
+    {
+        for (Vertex source : sources)
+        {
+            if (source >= this -> vertexCount)
+            {
+                throw std::out_of_range("MultiSourceBFS: source vertex out of range");
+            }
+        }
+
+        return multiSourceBfs(this -> vertexCount, sources, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphCSR<E>::WeakComponents(size_t threads)
+    {
+        return weakComponents(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphCSR<E>::StrongComponents()
+    {
+        return tarjanComponents(this -> vertexCount, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphCSR<E>::ParallelStrongComponents(size_t threads)
+    {
+        this -> refreshEdgeIndex();
+        return forwardBackwardComponents(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, [this](Vertex v, auto&& visit) {
+            this -> forEachPredecessor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphCSR<E>::writeBinary(const std::string& path)
+    {
+        writeGraphFile(path, this -> vertexCount, this -> vertices, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+}
@@ -0,0 +1,484 @@
+#pragma once
+#include "graph.h"
+#include "delta_stepping.h"
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace DataStructure
+{
+    // 二进制图文件格式（小端，所有段按 64 字节对齐）：
+    //   GraphFileHeader
+    //   payloads  E[vertexCount]            顶点数据，E 必须可平凡复制
+    //   offsets   uint64_t[vertexCount + 1] CSR 偏移
+    //   targets   uint32_t[edgeCount]       边的终点
+    //   weights   int32_t[edgeCount]        边权
+    // 文件可以直接 mmap 后按数组读取，不需要解析。
+    constexpr char GraphFileMagic[8] = {'D', 'S', 'G', 'R', 'A', 'P', 'H', '\0'};
+    constexpr uint32_t GraphFileVersion = 1;
+    constexpr uint64_t GraphFileAlign = 64;
+
+    struct GraphFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t payloadSize;       // sizeof(E)，读取时用来检查类型是否匹配
+        uint64_t vertexCount;
+        uint64_t edgeCount;
+        uint64_t payloadOffset;     // 各段在文件中的字节偏移
+        uint64_t offsetsOffset;
+        uint64_t targetsOffset;
+        uint64_t weightsOffset;
+    };
+
+    inline uint64_t graphFileAlign(uint64_t size)
+    {
+        return (size + GraphFileAlign - 1) / GraphFileAlign * GraphFileAlign;
+    }
+
+    // 把 vertexCount 个顶点的数据和邻接关系写成图文件。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)，会被依次调用三遍，不在内存中组装整张图。
+    template <typename E, typename Neighbors>
+    void writeGraphFile(const std::string& path, size_t vertexCount, const vector<E>& payloads, Neighbors&& neighbors)
+    {
+        static_assert(std::is_trivially_copyable<E>::value, "writeGraphFile: vertex payload must be trivially copyable");
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("writeGraphFile: cannot open " + path);
+        }
+
+        vector<uint64_t> offsets(vertexCount + 1, 0);
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            uint64_t degree = 0;
+            neighbors(v, [&](Vertex, int) {
+                degree ++;
+            });
+            offsets[v + 1] = offsets[v] + degree;
+        }
+
+        GraphFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, GraphFileMagic, sizeof(header.magic));
+        header.version = GraphFileVersion;
+        header.payloadSize = sizeof(E);
+        header.vertexCount = vertexCount;
+        header.edgeCount = offsets[vertexCount];
+        header.payloadOffset = graphFileAlign(sizeof(GraphFileHeader));
+        header.offsetsOffset = graphFileAlign(header.payloadOffset + sizeof(E) * vertexCount);
+        header.targetsOffset = graphFileAlign(header.offsetsOffset + sizeof(uint64_t) * (vertexCount + 1));
+        header.weightsOffset = graphFileAlign(header.targetsOffset + sizeof(uint32_t) * header.edgeCount);
+
+        uint64_t written = 0;
+        auto write = [&](const void* data, uint64_t size) {
+            out.write(static_cast<const char*>(data), size);
+            written += size;
+        };
+        auto pad = [&](uint64_t offset) {
+            static const char zeros[GraphFileAlign] = {};
+            write(zeros, offset - written);
+        };
+
+        write(&header, sizeof(header));
+        pad(header.payloadOffset);
+        write(payloads.data(), sizeof(E) * vertexCount);
+        pad(header.offsetsOffset);
+        write(offsets.data(), sizeof(uint64_t) * offsets.size());
+        pad(header.targetsOffset);
+
+        // 终点和边权分两遍写出，每遍用一个小缓冲区
+        vector<uint32_t> targetBuffer;
+        vector<int32_t> weightBuffer;
+        const size_t bufferSize = 1 << 16;
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            neighbors(v, [&](Vertex to, int) {
+                targetBuffer.push_back(static_cast<uint32_t>(to));
+                if (targetBuffer.size() == bufferSize)
+                {
+                    write(targetBuffer.data(), sizeof(uint32_t) * targetBuffer.size());
+                    targetBuffer.clear();
+                }
+            });
+        }
+        write(targetBuffer.data(), sizeof(uint32_t) * targetBuffer.size());
+        pad(header.weightsOffset);
+
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            neighbors(v, [&](Vertex, int weight) {
+                weightBuffer.push_back(weight);
+                if (weightBuffer.size() == bufferSize)
+                {
+                    write(weightBuffer.data(), sizeof(int32_t) * weightBuffer.size());
+                    weightBuffer.clear();
+                }
+            });
+        }
+        write(weightBuffer.data(), sizeof(int32_t) * weightBuffer.size());
+
+        if (!out)
+        {
+            throw std::runtime_error("writeGraphFile: write failed for " + path);
+        }
+    }
+
+    // 映射到文件的行主序距离矩阵，接口与 DistanceMatrix 相同。文件内容就是 rows * cols 个 int32_t，
+    // 矩阵比内存大时由操作系统按页换入换出；析构时解除映射，数据留在文件里。
+    class MappedDistanceMatrix
+    {
+    public:
+        MappedDistanceMatrix(const std::string& path, size_t rows, size_t cols, int value = INF);
+        MappedDistanceMatrix(MappedDistanceMatrix&& other) noexcept;
+        MappedDistanceMatrix(const MappedDistanceMatrix&) = delete;
+        MappedDistanceMatrix& operator=(const MappedDistanceMatrix&) = delete;
+        ~MappedDistanceMatrix();
+
+        size_t rows() const;
+        size_t cols() const;
+        int* row(size_t i);
+        const int* row(size_t i) const;
+        int& operator()(size_t i, size_t j);
+        int operator()(size_t i, size_t j) const;
+        int* data();
+        const int* data() const;
+        void flush();       // 把修改同步写回文件
+
+    private:
+        size_t rowCount;
+        size_t colCount;
+        void* base;
+        size_t length;
+    };
+
+    // 只读映射一个图文件，所有数组直接指向映射的内存
+    template <typename E>
+    class MappedGraph
+    {
+        static_assert(std::is_trivially_copyable<E>::value, "MappedGraph: vertex payload must be trivially copyable");
+
+    public:
+        MappedGraph(const std::string& path);
+        MappedGraph(MappedGraph&& other) noexcept;
+        MappedGraph(const MappedGraph&) = delete;
+        MappedGraph& operator=(const MappedGraph&) = delete;
+        ~MappedGraph();
+
+        size_t vertexCount() const;
+        size_t edgeCount() const;
+        const E& getVertex(Vertex vertex) const;
+        size_t degree(Vertex vertex) const;
+
+        const uint64_t* offsets() const;
+        const uint32_t* targets() const;
+        const int32_t* weights() const;
+
+        template <typename F>
+        void forEachNeighbor(Vertex v, F&& func) const;
+
+        vector<int> Dijkstra(Vertex start) const;
+        vector<int> DeltaStepping(Vertex start, int delta = 0, size_t threads = 0) const;
+
+    private:
+        void* base;
+        size_t length;
+        const GraphFileHeader* header;
+        const E* payloadData;
+        const uint64_t* offsetData;
+        const uint32_t* targetData;
+        const int32_t* weightData;
+    };
+
+    template <typename E>
+    MappedGraph<E>::MappedGraph(const std::string& path) : base(nullptr), length(0)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("MappedGraph: cannot open " + path);
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(GraphFileHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("MappedGraph: file too small " + path);
+        }
+        length = info.st_size;
+
+        base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+        {
+            base = nullptr;
+            throw std::runtime_error("MappedGraph: mmap failed for " + path);
+        }
+
+        const char* bytes = static_cast<const char*>(base);
+        header = reinterpret_cast<const GraphFileHeader*>(bytes);
+
+        auto fail = [&](const char* reason) {
+            ::munmap(base, length);
+            base = nullptr;
+            throw std::runtime_error(std::string("MappedGraph: ") + reason + " in " + path);
+        };
+
+        if (std::memcmp(header -> magic, GraphFileMagic, sizeof(GraphFileMagic)) != 0)
+        {
+            fail("bad magic");
+        }
+        if (header -> version != GraphFileVersion)
+        {
+            fail("unsupported version");
+        }
+        if (header -> payloadSize != sizeof(E))
+        {
+            fail("vertex payload size mismatch");
+        }
+        if (header -> weightsOffset + sizeof(int32_t) * header -> edgeCount > length ||
+            header -> targetsOffset + sizeof(uint32_t) * header -> edgeCount > header -> weightsOffset ||
+            header -> offsetsOffset + sizeof(uint64_t) * (header -> vertexCount + 1) > header -> targetsOffset ||
+            header -> payloadOffset + sizeof(E) * header -> vertexCount > header -> offsetsOffset)
+        {
+            fail("truncated file");
+        }
+
+        payloadData = reinterpret_cast<const E*>(bytes + header -> payloadOffset);
+        offsetData = reinterpret_cast<const uint64_t*>(bytes + header -> offsetsOffset);
+        targetData = reinterpret_cast<const uint32_t*>(bytes + header -> targetsOffset);
+        weightData = reinterpret_cast<const int32_t*>(bytes + header -> weightsOffset);
+
+        if (offsetData[header -> vertexCount] != header -> edgeCount)
+        {
+            fail("inconsistent offsets");
+        }
+    }
+
+    template <typename E>
+    MappedGraph<E>::MappedGraph(MappedGraph&& other) noexcept
+        : base(other.base), length(other.length), header(other.header), payloadData(other.payloadData),
+          offsetData(other.offsetData), targetData(other.targetData), weightData(other.weightData)
+    {
+        other.base = nullptr;
+        other.length = 0;
+    }
+
+    template <typename E>
+    MappedGraph<E>::~MappedGraph()
+    {
+        if (base != nullptr)
+        {
+            ::munmap(base, length);
+        }
+    }
+
+    template <typename E>
+    size_t MappedGraph<E>::vertexCount() const
+    {
+        return header -> vertexCount;
+    }
+
+    template <typename E>
+    size_t MappedGraph<E>::edgeCount() const
+    {
+        return header -> edgeCount;
+    }
+
+    template <typename E>
+    const E& MappedGraph<E>::getVertex(Vertex vertex) const
+    {
+        if (vertex >= header -> vertexCount)
+        {
+            throw std::out_of_range("getVertex: vertex out of range");
+        }
+        return payloadData[vertex];
+    }
+
+    template <typename E>
+    size_t MappedGraph<E>::degree(Vertex vertex) const
+    {
+        if (vertex >= header -> vertexCount)
+        {
+            throw std::out_of_range("degree: vertex out of range");
+        }
+        return offsetData[vertex + 1] - offsetData[vertex];
+    }
+
+    template <typename E>
+    const uint64_t* MappedGraph<E>::offsets() const
+    {
+        return offsetData;
+    }
+
+    template <typename E>
+    const uint32_t* MappedGraph<E>::targets() const
+    {
+        return targetData;
+    }
+
+    template <typename E>
+    const int32_t* MappedGraph<E>::weights() const
+    {
+        return weightData;
+    }
+
+    template <typename E>
+    template <typename F>
+    void MappedGraph<E>::forEachNeighbor(Vertex v, F&& func) const
+    {
+        for (uint64_t i = offsetData[v]; i < offsetData[v + 1]; i ++)
+        {
+            func(static_cast<Vertex>(targetData[i]), static_cast<int>(weightData[i]));
+        }
+    }
+
+    template <typename E>
+    vector<int> MappedGraph<E>::Dijkstra(Vertex start) const
+    {
+        if (start >= header -> vertexCount)
+        {
+            throw std::out_of_range("Dijkstra: start vertex is out of range");
+        }
+
+        DistanceHeap heap(header -> vertexCount);
+        vector<bool> visited(header -> vertexCount, false);
+        vector<int> ans(header -> vertexCount, INF);
+
+        ans[start] = 0;
+        heap.push(start, 0);
+
+        while (!heap.empty())
+        {
+            Vertex nearNode = heap.top();
+            int distance = heap.top_key();
+            heap.pop();
+
+            visited[nearNode] = true;
+
+            forEachNeighbor(nearNode, [&](Vertex to, int weight) {
+                if (!visited[to] && ans[to] > distance + weight)
+                {
+                    ans[to] = distance + weight;
+                    heap.push_or_decrease(to, ans[to]);
+                }
+            });
+        }
+
+        return ans;
+    }
+
+    template <typename E>
+    vector<int> MappedGraph<E>::DeltaStepping(Vertex start, int delta, size_t threads) const
+    {
+        if (start >= header -> vertexCount)
+        {
+            throw std::out_of_range("DeltaStepping: start vertex is out of range");
+        }
+
+        return deltaStepping(header -> vertexCount, start, delta, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    inline MappedDistanceMatrix::MappedDistanceMatrix(const std::string& path, size_t rows, size_t cols, int value)
+        : rowCount(rows), colCount(cols), base(nullptr), length(sizeof(int32_t) * rows * cols)
+    {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("MappedDistanceMatrix: cannot open " + path);
+        }
+        if (::ftruncate(fd, length) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("MappedDistanceMatrix: cannot resize " + path);
+        }
+        if (length == 0)
+        {
+            ::close(fd);
+            return;
+        }
+
+        base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+        {
+            base = nullptr;
+            throw std::runtime_error("MappedDistanceMatrix: mmap failed for " + path);
+        }
+        std::fill(data(), data() + rows * cols, value);
+    }
+
+    inline MappedDistanceMatrix::MappedDistanceMatrix(MappedDistanceMatrix&& other) noexcept
+        : rowCount(other.rowCount), colCount(other.colCount), base(other.base), length(other.length)
+    {
+        other.base = nullptr;
+        other.length = 0;
+    }
+
+    inline MappedDistanceMatrix::~MappedDistanceMatrix()
+    {
+        if (base != nullptr)
+        {
+            ::munmap(base, length);
+        }
+    }
+
+    inline size_t MappedDistanceMatrix::rows() const
+    {
+        return rowCount;
+    }
+
+    inline size_t MappedDistanceMatrix::cols() const
+    {
+        return colCount;
+    }
+
+    inline int* MappedDistanceMatrix::row(size_t i)
+    {
+        return data() + i * colCount;
+    }
+
+    inline const int* MappedDistanceMatrix::row(size_t i) const
+    {
+        return data() + i * colCount;
+    }
+
+    inline int& MappedDistanceMatrix::operator()(size_t i, size_t j)
+    {
+        return data()[i * colCount + j];
+    }
+
+    inline int MappedDistanceMatrix::operator()(size_t i, size_t j) const
+    {
+        return data()[i * colCount + j];
+    }
+
+    inline int* MappedDistanceMatrix::data()
+    {
+        return static_cast<int*>(base);
+    }
+
+    inline const int* MappedDistanceMatrix::data() const
+    {
+        return static_cast<const int*>(base);
+    }
+
+    inline void MappedDistanceMatrix::flush()
+    {
+        if (base != nullptr && ::msync(base, length, MS_SYNC) != 0)
+        {
+            throw std::runtime_error("MappedDistanceMatrix: msync failed");
+        }
+    }
+}
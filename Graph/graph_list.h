@@ -1,5 +1,14 @@
 #pragma once
 #include "graph.h"
+#include "astar.h"
+#include "bfs.h"
+#include "components.h"
+#include "delta_stepping.h"
+#include "johnson.h"
+#include "negative_cycle.h"
+#include "spfa.h"
+#include "shortest_path_tree.h"
+#include "graph_file.h"
 #include "graph_matrix.h"
 #include <forward_list>
 #include <queue>
@@ -11,18 +20,29 @@
 
 namespace DataStructure
 {
+    template <typename E>
+    class GraphCSR;
+
+    template <typename E>
+    class DynamicShortestPath;
+
     template <typename E>
     class GraphList: public Graph<E>
     {
         using PVI = std::pair<Vertex, int>;
+        friend class GraphCSR<E>;
+        friend class DynamicShortestPath<E>;
 
     public:
         GraphList<E>(int vertices);
+        // 批量建图：按起点计数排序后一次性填好各个邻接表，结果与依次调用 addEdge 相同
+        static GraphList<E> fromEdges(size_t vertexCount, const vector<Edge>& edges, size_t threads = 0);
         ~GraphList<E>() = default;
         virtual void addEdge(Vertex from, Vertex to, int weight = 1) override;
         virtual void removeEdge(Vertex from, Vertex to) override;
         virtual void printGraph() override;
         virtual vector<Vertex> getAdjacentVertices(Vertex vertex) override;
+        void writeBinary(const std::string& path);         // 写成可 mmap 的二进制图文件，见 graph_file.h
         virtual int getEdge(Vertex from, Vertex to) override;
         
 
@@ -30,11 +50,51 @@ namespace DataStructure
         virtual vector<int> Dijkstra(Vertex start) override;
         virtual vector<int> Bellman_Ford(Vertex start, int steps = -1) override;
         virtual vector<int> spfa(Vertex start) override;
+        vector<int> spfa(Vertex start, SpfaQueue strategy, size_t maxPops = 0);
+        // 同时填写前驱数组的版本，dist / pred / scratch 由调用方提供、可以反复使用，见 shortest_path_tree.h
+        void Dijkstra(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch);
+        void Bellman_Ford(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch, int steps = -1);
+        void spfa(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch);
         virtual bool containsNegativeCycle() override;
+        // 返回一个负权环上的顶点（依次相连，最后一个连回第一个），没有时返回空数组。
+        // 边数较多时按边并行松弛，否则用 Tarjan 子树拆解，见 negative_cycle.h
+        vector<Vertex> FindNegativeCycle(size_t threads = 0);
+        // Johnson 全源最短路，适合稀疏图，允许负权边，有负权环时抛出 std::runtime_error。
+        // 给出 path 时结果写进映射到该文件的矩阵，V x V 超过内存时也能算，见 johnson.h
+        DistanceMatrix Johnson(size_t threads = 0);
+        MappedDistanceMatrix Johnson(const std::string& path, size_t threads = 0);
         virtual MSTResult Prim() override;
+        MSTResult Prim(PrimStrategy strategy);
         virtual MSTResult Kruskal() override;
+        virtual vector<int> DeltaStepping(Vertex start, int delta = 0, size_t threads = 0) override;
+        // 忽略边权的 BFS，返回边数，不可达为 INF。方向优化版本在前沿变大时改为自底向上，需要反向邻接（见 refreshEdgeIndex）；
+        // MultiSourceBFS 每遍同时处理 64 个源点，结果第 i 行对应 sources[i]
+        vector<int> BFS(Vertex start);
+        vector<int> DirectionOptimizingBFS(Vertex start);
+        DistanceMatrix MultiSourceBFS(const vector<Vertex>& sources);
+        // 连通分量，结果为 (分量数, 每个顶点的分量编号)：WeakComponents 忽略边的方向；
+        // StrongComponents 为非递归 Tarjan，编号按逆拓扑序；ParallelStrongComponents 为并行 forward-backward
+        ComponentResult WeakComponents(size_t threads = 0);
+        ComponentResult StrongComponents();
+        ComponentResult ParallelStrongComponents(size_t threads = 0);
+        // A* 点对点最短路，边权需非负。heuristic(getVertex(v), getVertex(to)) 返回 v 到 to 距离的下界，
+        // 例如顶点数据是坐标时可以取欧氏距离。工作区在多次调用之间复用，不能并发调用。
+        template <typename Heuristic>
+        PathResult AStar(Vertex from, Vertex to, Heuristic heuristic);
+    protected:
+        virtual void DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch) override;
+
+    private:
+        template <typename F>
+        void forEachNeighbor(Vertex v, F&& func);
+
+    private:
+        MSTResult PrimHeap();
+        MSTResult PrimDense();
+
     private:
         std::vector<std::forward_list<PVI>> adjList;
+        AStarScratch astarScratch;
     };
 
     template <typename E>
@@ -44,6 +104,43 @@ namespace DataStructure
         adjList.resize(vertices);
     }
 
+    template <typename E>
+    GraphList<E> GraphList<E>::fromEdges(size_t vertexCount, const vector<Edge>& edges, size_t threads)
+    {
+        GraphList<E> graph(vertexCount);
+
+        for (const auto& e : edges)
+        {
+            if (e.from >= vertexCount || e.to >= vertexCount)
+            {
+                throw std::out_of_range("fromEdges: Vertex out of range");
+            }
+        }
+
+        vector<size_t> offsets;
+        vector<Edge> sorted;
+        sortEdgesBySource(vertexCount, edges, offsets, sorted, threads);
+
+        // addEdge 是头插，所以同一起点的边按输入顺序依次头插
+        parallelRange(vertexCount, threads, 1 << 12, [&](size_t, size_t begin, size_t end) {
+            for (Vertex v = begin; v < end; v ++)
+            {
+                for (size_t i = offsets[v]; i < offsets[v + 1]; i ++)
+                {
+                    graph.adjList[v].emplace_front(sorted[i].to, sorted[i].weight);
+                }
+            }
+        });
+
+        graph.edges.reserve(sorted.size());
+        for (const auto& e : sorted)
+        {
+            graph.edges.relax(e.from, e.to, e.weight);
+        }
+
+        return graph;
+    }
+
     template <typename E>
     void GraphList<E>::addEdge(Vertex from, Vertex to, int weight)
     {
@@ -55,16 +152,7 @@ namespace DataStructure
         }
         adjList[from].emplace_front(std::make_pair(to, weight));
 
-        Edge e = {from, to, weight};
-        
-        auto it = this -> edges.find(e);
-
-        if (it != this -> edges.end() && it -> weight > weight)
-        {
-            this -> edges.erase(it);
-            this -> edges.insert(e);
-        }
-        else if (it == this -> edges.end()) this -> edges.insert(e);
+        this -> edges.relax(from, to, weight);
     }
 
     template <typename E>
@@ -78,13 +166,16 @@ namespace DataStructure
             return edge.first == to;
         });
 
-        Edge e = {from, to, 1};
-        
-        auto it = this -> edges.find(e);
+        this -> edges.erase(from, to);
+    }
 
-        if (it != this -> edges.end())
+    template <typename E>
+    template <typename F>
+    void GraphList<E>::forEachNeighbor(Vertex v, F&& func)
+    {
+        for (const auto& edge : adjList[v])
         {
-            this -> edges.erase(it);
+            func(edge.first, edge.second);
         }
     }
 
@@ -143,41 +234,41 @@ namespace DataStructure
             throw std::out_of_range("Dijkstra: start vertex is out of range");
         }
 
-        using PIV = std::pair<int, Vertex>;
+        vector<int> ans(this -> vertexCount);
+        ShortestPathScratch scratch(this -> vertexCount);
+        DijkstraInto(start, ans.data(), scratch);
+        return ans;
+    }
 
-        std::priority_queue<PIV, vector<PIV>, std::greater<PIV>> heap;
+    template <typename E>
+    void GraphList<E>::DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch)
+    {
+        DistanceHeap& heap = scratch.heap;
+        vector<bool>& visited = scratch.visited;
 
-        vector<bool> visited(this -> vertexCount, false);
-        vector<E> ans(this -> vertexCount, INF);
+        std::fill(ans, ans + this -> vertexCount, INF);
+        visited.assign(this -> vertexCount, false);
 
-        heap.push(std::make_pair(start, 0));
+        ans[start] = 0;
+        heap.push(start, 0);
 
-        while (heap.size())
+        while (!heap.empty())
         {
-            auto p = heap.top();
+            Vertex nearNode = heap.top();
+            int distance = heap.top_key();
             heap.pop();
 
-            int distance = p.first;
-            Vertex nearNode = p.second;
-
-            if (visited[nearNode])
-            {
-                continue;
-            }
-
             visited[nearNode] = true;
 
             for (const auto& edge : adjList[nearNode])
             {
-                if (ans[edge.first] > distance + edge.second)
+                if (!visited[edge.first] && ans[edge.first] > distance + edge.second)
                 {
                     ans[edge.first] = distance + edge.second;
-                    heap.push(std::make_pair(ans[edge.first], edge.first));
+                    heap.push_or_decrease(edge.first, ans[edge.first]);
                 }
             }
         }
-
-        return ans;
     }
 
     template <typename E>
@@ -248,87 +339,162 @@ namespace DataStructure
     }
 
     template <typename E>
-    bool GraphList<E>::containsNegativeCycle()
+    vector<int> GraphList<E>::spfa(Vertex start, SpfaQueue strategy, size_t maxPops)
     {
-        std::queue<Vertex> q;
-        vector<int> dist(this -> vertexCount, 0);
-        vector<uint> steps(this -> vertexCount, 0);
-        vector<bool> inQueue(this -> vertexCount, true);
-        
-        for (Vertex i = 0; i < this -> vertexCount; i++)
+        if (start >= this -> vertexCount)
         {
-            q.push(i);
+            throw std::out_of_range("spfa: start vertex is out of range");
         }
 
-        while (!q.empty())
+        return spfaWithQueue(this -> vertexCount, start, strategy, maxPops, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphList<E>::Dijkstra(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        if (start >= this -> vertexCount)
         {
-            Vertex v = q.front();
-            q.pop();
-            inQueue[v] = false;
+            throw std::out_of_range("Dijkstra: start vertex is out of range");
+        }
 
-            for (const auto& e : adjList[v])
-            {
-                Vertex to = e.first;
-                int weight = e.second;
+        dijkstraTree(this -> vertexCount, start, dist, pred, scratch, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
 
-                if (dist[to] > dist[v] + weight)
-                {
-                    dist[to] = dist[v] + weight;
-                    steps[to] = steps[v] + 1;
+    template <typename E>
+    void GraphList<E>::Bellman_Ford(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch, int steps)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("Bellman-ford: start vertex is out of range");
+        }
 
-                    if (steps[to] >= this -> vertexCount)
-                    {
-                        return true;
-                    }
+        bellmanFordTree(this -> vertexCount, start, steps, this -> edges, dist, pred, scratch);
+    }
 
-                    if (!inQueue[to])
-                    {
-                        q.push(to);
-                    }
-                }
-            }
+    template <typename E>
+    void GraphList<E>::spfa(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("spfa: start vertex is out of range");
         }
 
-        return false;
+        spfaTree(this -> vertexCount, start, dist, pred, scratch, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    bool GraphList<E>::containsNegativeCycle()
+    {
+        return !FindNegativeCycle().empty();
+    }
+
+    template <typename E>
+    vector<Vertex> GraphList<E>::FindNegativeCycle(size_t threads)
+    {
+        if (this -> edges.size() >= NegativeCycleParallelThreshold &&
+            parallelWorkers(this -> edges.size(), threads, 1 << 14) > 1)
+        {
+            const vector<Edge> edgeList(this -> edges.begin(), this -> edges.end());
+            return findNegativeCycleParallel(this -> vertexCount, edgeList, threads);
+        }
+
+        return findNegativeCycle(this -> vertexCount, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    DistanceMatrix GraphList<E>::Johnson(size_t threads)
+    {
+        DistanceMatrix ans(this -> vertexCount, this -> vertexCount);
+        johnson(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, [&ans](Vertex start) {
+            return ans.row(start);
+        });
+        return ans;
+    }
+
+    template <typename E>
+    MappedDistanceMatrix GraphList<E>::Johnson(const std::string& path, size_t threads)
+    {
+        MappedDistanceMatrix ans(path, this -> vertexCount, this -> vertexCount);
+        johnson(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, [&ans](Vertex start) {
+            return ans.row(start);
+        });
+        return ans;
     }
 
     template <typename E>
     MSTResult GraphList<E>::Prim()
+    {
+        return Prim(PrimStrategy::Heap);
+    }
+
+    template <typename E>
+    MSTResult GraphList<E>::Prim(PrimStrategy strategy)
+    {
+        if (strategy == PrimStrategy::Dense)
+        {
+            return PrimDense();
+        }
+        return PrimHeap();
+    }
+
+    template <typename E>
+    MSTResult GraphList<E>::PrimDense()
     {
         vector<int> distences(this -> vertexCount, INF);
-        vector<int> pre(this -> vertexCount, -1);
+        vector<Vertex> pre(this -> vertexCount, 0);
         vector<bool> inMST(this -> vertexCount, false);
         vector<Edge> MSTedges;
         int edgeSum = 0;
+
+        if (this -> vertexCount == 0)
+        {
+            return std::make_pair(0, vector<Edge>());
+        }
+
         distences[0] = 0;
-        
-        for (int i = 0; i < this -> vertexCount; i ++)
+
+        for (Vertex i = 0; i < this -> vertexCount; i ++)
         {
-            int nearNode = -1;
+            Vertex nearNode = this -> vertexCount;
 
             for (Vertex j = 0; j < this -> vertexCount; j ++)
             {
-                if (! inMST[j] && (nearNode == -1 || distences[j] > distences[nearNode]))
+                if (!inMST[j] && (nearNode == this -> vertexCount || distences[j] < distences[nearNode]))
                 {
                     nearNode = j;
                 }
             }
-            
+
             if (distences[nearNode] == INF)
             {
                 return std::make_pair(-1, vector<Edge>()); // 不存在MST
             }
 
             inMST[nearNode] = true;
-            MSTedges.emplace_back(Edge{(Vertex)(pre[nearNode]), (Vertex)(nearNode), distences[nearNode]});
-            edgeSum += distences[nearNode];
+            if (nearNode != 0)
+            {
+                MSTedges.emplace_back(Edge{pre[nearNode], nearNode, distences[nearNode]});
+                edgeSum += distences[nearNode];
+            }
 
             for (const auto& e : adjList[nearNode])
             {
                 Vertex j = e.first;
                 int dist = e.second;
 
-                if (dist < distences[j])
+                if (!inMST[j] && dist < distences[j])
                 {
                     distences[j] = dist;
                     pre[j] = nearNode;
@@ -340,49 +506,207 @@ namespace DataStructure
     }
 
     template <typename E>
-    MSTResult GraphList<E>::Kruskal()
+    MSTResult GraphList<E>::PrimHeap()
     {
+        DistanceHeap heap(this -> vertexCount);
+
+        vector<int> distences(this -> vertexCount, INF);
+        vector<Vertex> pre(this -> vertexCount, 0);
+        vector<bool> inMST(this -> vertexCount, false);
         vector<Edge> MSTedges;
         int edgeSum = 0;
-        uint edgeCount = 0;
+        size_t count = 0;
+
+        if (this -> vertexCount == 0)
+        {
+            return std::make_pair(0, vector<Edge>());
+        }
+
+        distences[0] = 0;
+        heap.push(0, 0);
+
+        while (!heap.empty())
+        {
+            Vertex nearNode = heap.top();
+            heap.pop();
+
+            inMST[nearNode] = true;
+            count ++;
+            if (nearNode != 0)
+            {
+                MSTedges.emplace_back(Edge{pre[nearNode], nearNode, distences[nearNode]});
+                edgeSum += distences[nearNode];
+            }
+
+            for (const auto& e : adjList[nearNode])
+            {
+                Vertex j = e.first;
+                int dist = e.second;
+
+                if (!inMST[j] && dist < distences[j])
+                {
+                    distences[j] = dist;
+                    pre[j] = nearNode;
+                    heap.push_or_decrease(j, dist);
+                }
+            }
+        }
 
-        vector<Vertex> father(this -> vertexCount);
-        for (int i = 0; i < this -> vertexCount; ++i)
+        if (count != this -> vertexCount)
         {
-            father[i] = i;
+            return std::make_pair(-1, vector<Edge>()); // 不存在MST
         }
 
+        return std::make_pair(edgeSum, std::move(MSTedges));
+    }
+
+    template <typename E>
+    MSTResult GraphList<E>::Kruskal()
+    {
+        vector<Edge> MSTedges;
+        int edgeSum = 0;
+        DisjointSet set(this -> vertexCount);
+
         //边的存储可以直接加一个成员变量，在插入的时候就维护
-        vector<Edge> edges{this -> edges.begin(), this -> edges.end()};                                                                                                                                                                                                                                                          ;
+        vector<Edge> edges{this -> edges.begin(), this -> edges.end()};
 
         std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
             return a.weight < b.weight;
         });
 
-        std::function<Vertex(Vertex)> find = [&](Vertex x) { //有趣的写法
-            if (father[x] != x) {
-                father[x] = find(father[x]);
-            }
-            return father[x];
-        };
-
         for (const auto& edge : edges)
         {
-            Vertex a = edge.from, b = edge.to;
-            if (find(a) != find(b))
+            if (set.unite(edge.from, edge.to))
             {
-                father[find(a)] = find(b);
                 MSTedges.emplace_back(edge);
                 edgeSum += edge.weight;
-                edgeCount ++;
             }
         }
 
-        if (edgeCount != this -> vertexCount - 1)
+        if (MSTedges.size() + 1 != this -> vertexCount)
         {
             return std::make_pair(-1, vector<Edge>());
         }
 
         return std::make_pair(edgeSum, std::move(MSTedges));
     }
-}
\ No newline at end of file
+
+    template <typename E>
+    vector<int> GraphList<E>::DeltaStepping(Vertex start, int delta, size_t threads)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("DeltaStepping: start vertex is out of range");
+        }
+
+        return deltaStepping(this -> vertexCount, start, delta, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    vector<int> GraphList<E>::BFS(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("BFS: start vertex is out of range");
+        }
+
+        return breadthFirst(this -> vertexCount, start, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    vector<int> GraphList<E>::DirectionOptimizingBFS(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("DirectionOptimizingBFS: start vertex is out of range");
+        }
+
+        this -> refreshEdgeIndex();
+        const AdjacencyIndex& forward = this -> edgeIndex[0];
+
+        auto predecessors = [this](Vertex v, auto&& visit) {
+            this -> forEachPredecessor(v, visit);
+        };
+        auto degree = [&forward](Vertex v) {
+            return forward.offsets[v + 1] - forward.offsets[v];
+        };
+
+        return directionOptimizingBfs(this -> vertexCount, start, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, predecessors, degree);
+    }
+
+    template <typename E>
+    DistanceMatrix GraphList<E>::MultiSourceBFS(const vector<Vertex>& sources)
+    {
+        for (Vertex source : sources)
+        {
+            if (source >= this -> vertexCount)
+            {
+                throw std::out_of_range("MultiSourceBFS: source vertex out of range");
+            }
+        }
+
+        return multiSourceBfs(this -> vertexCount, sources, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphList<E>::WeakComponents(size_t threads)
+    {
+        return weakComponents(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphList<E>::StrongComponents()
+    {
+        return tarjanComponents(this -> vertexCount, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphList<E>::ParallelStrongComponents(size_t threads)
+    {
+        this -> refreshEdgeIndex();
+        return forwardBackwardComponents(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, [this](Vertex v, auto&& visit) {
+            this -> forEachPredecessor(v, visit);
+        });
+    }
+
+    template <typename E>
+    template <typename Heuristic>
+    PathResult GraphList<E>::AStar(Vertex from, Vertex to, Heuristic heuristic)
+    {
+        if (from >= this -> vertexCount || to >= this -> vertexCount)
+        {
+            throw std::out_of_range("AStar: Vertex out of range");
+        }
+
+        const E& goal = this -> vertices[to];
+        auto estimate = [&](Vertex v) {
+            return static_cast<int>(heuristic(this -> vertices[v], goal));
+        };
+
+        return aStar(this -> vertexCount, from, to, estimate, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, astarScratch);
+    }
+
+    template <typename E>
+    void GraphList<E>::writeBinary(const std::string& path)
+    {
+        writeGraphFile(path, this -> vertexCount, this -> vertices, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+}
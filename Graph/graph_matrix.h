@@ -1,6 +1,15 @@
 #pragma once
 #include "graph.h"
+#include "bfs.h"
+#include "components.h"
+#include "delta_stepping.h"
+#include "negative_cycle.h"
+#include "spfa.h"
+#include "shortest_path_tree.h"
+#include "graph_file.h"
+#include "aligned_allocator.h"
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <queue>
 #include <stdexcept>
@@ -15,59 +24,164 @@ namespace DataStructure
     {
     public:
         GraphMatrix(int vertexCount_);
+        // 批量建图：按起点计数排序后由多个线程分别填写互不相交的行，结果与依次调用 addEdge 相同
+        static GraphMatrix<E> fromEdges(size_t vertexCount, const vector<Edge>& edges, size_t threads = 0);
         virtual void addEdge(Vertex from, Vertex to, int weight = 1) override;
         virtual void removeEdge(Vertex from, Vertex to) override;
         virtual int getEdge(Vertex from, Vertex to) override;
         virtual void printGraph() override;
         virtual vector<Vertex> getAdjacentVertices(Vertex vertex) override;
+        void writeBinary(const std::string& path);         // 写成可 mmap 的二进制图文件，见 graph_file.h
 
 
         virtual vector<int> Dijkstra(Vertex start) override;
         virtual vector<int> Bellman_Ford(Vertex start, int steps = -1)override;
         vector<vector<int>> floyd();
+        DistanceMatrix floydBlocked(size_t blockSize = 64, size_t threads = 0);
         virtual vector<int> spfa(Vertex start)override;
+        vector<int> spfa(Vertex start, SpfaQueue strategy, size_t maxPops = 0);
+        // 同时填写前驱数组的版本，dist / pred / scratch 由调用方提供、可以反复使用，见 shortest_path_tree.h
+        void Dijkstra(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch);
+        void Bellman_Ford(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch, int steps = -1);
+        void spfa(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch);
         virtual bool containsNegativeCycle()override;
+        // 返回一个负权环上的顶点（依次相连，最后一个连回第一个），没有时返回空数组。
+        // 边数较多时按边并行松弛，否则用 Tarjan 子树拆解，见 negative_cycle.h
+        vector<Vertex> FindNegativeCycle(size_t threads = 0);
         virtual MSTResult Prim() override;
+        MSTResult Prim(PrimStrategy strategy);
         virtual MSTResult Kruskal() override;
+        virtual vector<int> DeltaStepping(Vertex start, int delta = 0, size_t threads = 0) override;
+        // 忽略边权的 BFS，返回边数，不可达为 INF。方向优化版本在前沿变大时改为自底向上，需要反向邻接（见 refreshEdgeIndex）；
+        // MultiSourceBFS 每遍同时处理 64 个源点，结果第 i 行对应 sources[i]
+        vector<int> BFS(Vertex start);
+        vector<int> DirectionOptimizingBFS(Vertex start);
+        DistanceMatrix MultiSourceBFS(const vector<Vertex>& sources);
+        // 连通分量，结果为 (分量数, 每个顶点的分量编号)：WeakComponents 忽略边的方向；
+        // StrongComponents 为非递归 Tarjan，编号按逆拓扑序；ParallelStrongComponents 为并行 forward-backward
+        ComponentResult WeakComponents(size_t threads = 0);
+        ComponentResult StrongComponents();
+        ComponentResult ParallelStrongComponents(size_t threads = 0);
 
         ~GraphMatrix() = default;
 
-    private:    
-        std::vector<std::vector<int>> adjMatrix;
-    };  
+    protected:
+        virtual void DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch) override;
+
+    private:
+        MSTResult PrimHeap();
+        MSTResult PrimDense();
+        static void floydTile(int* dist, size_t stride, size_t iBegin, size_t iEnd,
+                              size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd);
+
+    private:
+        int* matrixRow(Vertex v);
+        template <typename F>
+        void forEachNeighbor(Vertex v, F&& func);
+
+    private:
+        static constexpr size_t alignment = 64;                     // 一条缓存行，也是 AVX-512 的宽度
+        static constexpr size_t rowAlign = alignment / sizeof(int);
+
+        // 邻接矩阵按行连续存放在一块对齐的内存中，每行补齐到 stride 个元素
+        size_t stride;
+        std::vector<int, AlignedAllocator<int, alignment>> adjMatrix;
+        // 按位存放的边存在矩阵，每行 bitStride 个 64 位字，遍历邻居时只看置位的列
+        size_t bitStride;
+        std::vector<uint64_t> adjBits;
+    };
 
     template <typename E>
     GraphMatrix<E>::GraphMatrix(int vertexCount_): Graph<E>(vertexCount_)
     {
-        adjMatrix.resize(this -> vertexCount, vector<int>(this -> vertexCount, INF));
+        stride = (this -> vertexCount + rowAlign - 1) / rowAlign * rowAlign;
+        adjMatrix.assign(this -> vertexCount * stride, INF);
+        bitStride = (this -> vertexCount + 63) / 64;
+        adjBits.assign(this -> vertexCount * bitStride, 0);
         for (Vertex i = 0; i < this -> vertexCount; i++)
         {
-            adjMatrix[i][i] = 0;
+            matrixRow(i)[i] = 0;
         }
     }
+
     template <typename E>
-    void GraphMatrix<E>::addEdge(Vertex from, Vertex to, int weight)
+    int* GraphMatrix<E>::matrixRow(Vertex v)
     {
-        if (from == to) return;
+        return adjMatrix.data() + v * stride;
+    }
 
-        if (from >= this -> vertexCount || to >= this -> vertexCount)
+    // 按列号递增的顺序对 v 的每条出边调用 func(to, weight)
+    template <typename E>
+    template <typename F>
+    void GraphMatrix<E>::forEachNeighbor(Vertex v, F&& func)
+    {
+        const uint64_t* bits = adjBits.data() + v * bitStride;
+        const int* row = matrixRow(v);
+        for (size_t w = 0; w < bitStride; w ++)
         {
-            throw std::runtime_error("addEdge: vertex out of range");
+            uint64_t word = bits[w];
+            while (word)
+            {
+                Vertex to = w * 64 + __builtin_ctzll(word);
+                word &= word - 1;
+                func(to, row[to]);
+            }
         }
-        adjMatrix[from][to] = std::min(weight, adjMatrix[from][to]);
+    }
 
-        Edge e = {from, to, weight};
-        
-        auto it = this -> edges.find(e);
+    template <typename E>
+    GraphMatrix<E> GraphMatrix<E>::fromEdges(size_t vertexCount, const vector<Edge>& edges, size_t threads)
+    {
+        GraphMatrix<E> graph(vertexCount);
 
-        if (it == this -> edges.end())
+        for (const auto& e : edges)
         {
-            this -> edges.insert(e);
+            if (e.from >= vertexCount || e.to >= vertexCount)
+            {
+                throw std::runtime_error("fromEdges: vertex out of range");
+            }
         }
-        else
+
+        vector<size_t> offsets;
+        vector<Edge> sorted;
+        sortEdgesBySource(vertexCount, edges, offsets, sorted, threads);
+
+        parallelRange(vertexCount, threads, 1 << 8, [&](size_t, size_t begin, size_t end) {
+            for (Vertex v = begin; v < end; v ++)
+            {
+                int* row = graph.matrixRow(v);
+                uint64_t* bits = graph.adjBits.data() + v * graph.bitStride;
+                for (size_t i = offsets[v]; i < offsets[v + 1]; i ++)
+                {
+                    Vertex to = sorted[i].to;
+                    row[to] = std::min(row[to], sorted[i].weight);
+                    bits[to / 64] |= uint64_t(1) << (to % 64);
+                }
+            }
+        });
+
+        graph.edges.reserve(sorted.size());
+        for (const auto& e : sorted)
+        {
+            graph.edges.relax(e.from, e.to, e.weight);
+        }
+
+        return graph;
+    }
+
+    template <typename E>
+    void GraphMatrix<E>::addEdge(Vertex from, Vertex to, int weight)
+    {
+        if (from == to) return;
+
+        if (from >= this -> vertexCount || to >= this -> vertexCount)
         {
-            it -> weight = std::min(it -> weight, weight);
+            throw std::runtime_error("addEdge: vertex out of range");
         }
+        matrixRow(from)[to] = std::min(weight, matrixRow(from)[to]);
+        adjBits[from * bitStride + to / 64] |= uint64_t(1) << (to % 64);
+
+        this -> edges.relax(from, to, weight);
     }
 
     template <typename E>
@@ -77,14 +191,12 @@ namespace DataStructure
         {
             throw std::runtime_error("removeEdge: vertex out of range");
         }
-        Edge e = {from, to, adjMatrix[from][to]};
-        
-        auto it = this -> edges.find(e);
-        if (it != this -> edges.end())
+        this -> edges.erase(from, to);
+        if (from != to)
         {
-            this -> edges.erase(it);
+            matrixRow(from)[to] = INF;
+            adjBits[from * bitStride + to / 64] &= ~(uint64_t(1) << (to % 64));
         }
-        adjMatrix[from][to] = INF;
     }
 
     template <typename E>
@@ -94,7 +206,7 @@ namespace DataStructure
         {
             throw std::runtime_error("getEdge: vertex out of range");
         }
-        return adjMatrix[from][to];
+        return matrixRow(from)[to];
     }
 
     template <typename E>
@@ -107,13 +219,9 @@ namespace DataStructure
             throw std::runtime_error("getAdjacentVertices: vertex out of range");
         }
         vector<Vertex> ans;
-        for (Vertex i = 0; i < this -> vertexCount; i++)
-        {
-            if (adjMatrix[vertex][i] != INF || i != vertex)
-            {
-                ans.push_back(i);
-            }
-        }
+        forEachNeighbor(vertex, [&](Vertex to, int) {
+            ans.push_back(to);
+        });
         return ans;
     }
 
@@ -124,13 +232,9 @@ namespace DataStructure
         for (Vertex i = 0; i < this -> vertexCount; i++)
         {
             std::cout << i << ": ";
-            for (size_t j = 0; j < this -> vertexCount; j++)
-            {
-                if (adjMatrix[i][j] != INF && i != j)
-                {
-                    std::printf("(%lu, %d) ", j, adjMatrix[i][j]);
-                }
-            }
+            forEachNeighbor(i, [](Vertex j, int weight) {
+                std::printf("(%lu, %d) ", j, weight);
+            });
             std::cout << std::endl;
         }
     }
@@ -143,49 +247,128 @@ namespace DataStructure
             throw std::out_of_range("Dijkstra: start out of range");
         }
 
-        vector<bool> visited(this -> vertexCount, false);
-        vector<int> ans(this -> vertexCount, INF);
+        vector<int> ans(this -> vertexCount);
+        ShortestPathScratch scratch(this -> vertexCount);
+        DijkstraInto(start, ans.data(), scratch);
+        return ans;
+    }
+
+    template <typename E>
+    void GraphMatrix<E>::DijkstraInto(Vertex start, int* ans, ShortestPathScratch& scratch)
+    {
+        DistanceHeap& heap = scratch.heap;
+        vector<bool>& visited = scratch.visited;
+
+        std::fill(ans, ans + this -> vertexCount, INF);
+        visited.assign(this -> vertexCount, false);
 
         ans[start] = 0;
+        heap.push(start, 0);
 
-        for (Vertex i = 0; i < this -> vertexCount; i ++)
+        while (!heap.empty())
         {
-            Vertex nearNode = INF;
-            for (Vertex j = 0; j < this -> vertexCount; j ++)
-            {
-                if (!visited[j] && (nearNode == INF || ans[j] < ans[nearNode]))
-                {
-                    nearNode = j;
-                }
-            }
+            Vertex nearNode = heap.top();
+            int distance = heap.top_key();
+            heap.pop();
 
             visited[nearNode] = true;
-            for (Vertex j = 0; j < this -> vertexCount; j ++)
-            {
-                if (adjMatrix[nearNode][j] != INF)
+
+            forEachNeighbor(nearNode, [&](Vertex j, int weight) {
+                if (!visited[j] && ans[j] > distance + weight)
                 {
-                    ans[j] = std::min(ans[j], ans[nearNode] + adjMatrix[nearNode][j]);
+                    ans[j] = distance + weight;
+                    heap.push_or_decrease(j, ans[j]);
                 }
-            }
+            });
         }
-        return ans;
     }
 
     template <typename E>
     vector<vector<int>> GraphMatrix<E>::floyd()
     {
-        auto ans = adjMatrix;
+        DistanceMatrix dist = floydBlocked();
 
-        for (Vertex k = 0; k < this -> vertexCount; ++ k)
+        vector<vector<int>> ans(this -> vertexCount);
+        for (Vertex i = 0; i < this -> vertexCount; ++ i)
         {
-            for (Vertex i = 0; i < this -> vertexCount; ++ i)
+            ans[i].assign(dist.row(i), dist.row(i) + this -> vertexCount);
+        }
+        return ans;
+    }
+
+    // 对 [iBegin, iEnd) x [jBegin, jEnd) 这一块用 [kBegin, kEnd) 作中转点做 min-plus 更新。
+    // 最内层是对两行连续内存的逐元素 min，编译器可以直接向量化。
+    template <typename E>
+    void GraphMatrix<E>::floydTile(int* dist, size_t stride, size_t iBegin, size_t iEnd,
+                                   size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd)
+    {
+        for (size_t k = kBegin; k < kEnd; ++ k)
+        {
+            const int* rowK = dist + k * stride;
+            for (size_t i = iBegin; i < iEnd; ++ i)
             {
-                for (Vertex j = 0; j < this -> vertexCount; ++ j)
+                int* rowI = dist + i * stride;
+                const int ik = rowI[k];
+                for (size_t j = jBegin; j < jEnd; ++ j)
                 {
-                    ans[i][j] = std::min(ans[i][j], ans[i][k] + ans[k][j]);
+                    rowI[j] = std::min(rowI[j], ik + rowK[j]);
                 }
             }
         }
+    }
+
+    // 分块 Floyd：每一轮 kb 先算对角块，再并行算 kb 所在的行块和列块，最后并行算其余块。
+    // 每块的工作集只有三块 blockSize x blockSize，能留在缓存里。
+    template <typename E>
+    DistanceMatrix GraphMatrix<E>::floydBlocked(size_t blockSize, size_t threads)
+    {
+        const size_t n = this -> vertexCount;
+        DistanceMatrix ans(n, n);
+        for (Vertex i = 0; i < n; ++ i)
+        {
+            std::copy(matrixRow(i), matrixRow(i) + n, ans.row(i));
+        }
+
+        if (blockSize == 0) blockSize = 64;
+        const size_t blocks = (n + blockSize - 1) / blockSize;
+        int* dist = ans.data();
+
+        auto begin = [&](size_t b) { return b * blockSize; };
+        auto end = [&](size_t b) { return std::min(n, (b + 1) * blockSize); };
+
+        for (size_t kb = 0; kb < blocks; ++ kb)
+        {
+            const size_t kBegin = begin(kb), kEnd = end(kb);
+
+            floydTile(dist, n, kBegin, kEnd, kBegin, kEnd, kBegin, kEnd);
+
+            // 第 kb 行与第 kb 列的其它块，前 blocks 个是行块，后 blocks 个是列块
+            parallelRange(2 * blocks, threads, 1, [&](size_t, size_t first, size_t last) {
+                for (size_t t = first; t < last; ++ t)
+                {
+                    size_t b = t % blocks;
+                    if (b == kb) continue;
+                    if (t < blocks)
+                    {
+                        floydTile(dist, n, kBegin, kEnd, begin(b), end(b), kBegin, kEnd);
+                    }
+                    else
+                    {
+                        floydTile(dist, n, begin(b), end(b), kBegin, kEnd, kBegin, kEnd);
+                    }
+                }
+            });
+
+            parallelRange(blocks * blocks, threads, 1, [&](size_t, size_t first, size_t last) {
+                for (size_t t = first; t < last; ++ t)
+                {
+                    size_t ib = t / blocks, jb = t % blocks;
+                    if (ib == kb || jb == kb) continue;
+                    floydTile(dist, n, begin(ib), end(ib), begin(jb), end(jb), kBegin, kEnd);
+                }
+            });
+        }
+
         return ans;
     }
 
@@ -240,102 +423,154 @@ namespace DataStructure
             q.pop();
             inQueue[v] = false;
 
-            for (int i = 0; i < this -> vertexCount; i ++)
-            {
-                if (this -> adjMatrix[v][i] != INF && i != v && ans[i] > ans[v] + this -> adjMatrix[v][i])
+            forEachNeighbor(v, [&](Vertex i, int weight) {
+                if (ans[i] > ans[v] + weight)
                 {
-                    ans[i] = ans[v] + this -> adjMatrix[v][i];
+                    ans[i] = ans[v] + weight;
                     if (!inQueue[i])
                     {
                         q.push(i);
                         inQueue[i] = true;
                     }
                 }
-            }
+            });
         }
         
         return ans;
     }
 
     template <typename E>
-    bool GraphMatrix<E>::containsNegativeCycle()
+    vector<int> GraphMatrix<E>::spfa(Vertex start, SpfaQueue strategy, size_t maxPops)
     {
-        std::queue<Vertex> q;
-        vector<int> dist(this -> vertexCount, 0);
-        vector<uint> steps(this -> vertexCount, 0);
-        vector<bool> inQueue(this -> vertexCount, true);
-        
-        for (Vertex i = 0; i < this -> vertexCount; i++)
+        if (start >= this -> vertexCount)
         {
-            q.push(i);
+            throw std::out_of_range("spfa: start out of range");
         }
 
-        while (!q.empty())
+        return spfaWithQueue(this -> vertexCount, start, strategy, maxPops, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphMatrix<E>::Dijkstra(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        if (start >= this -> vertexCount)
         {
-            Vertex v = q.front();
-            q.pop();
-            inQueue[v] = false;
-            for (Vertex j = 0; j < this -> vertexCount; j ++)
-            {
-                if (adjMatrix[v][j] != INF && v != j)
-                {
-                    if (dist[j] > dist[v] + adjMatrix[v][j])
-                    {
-                        dist[j] = dist[v] + adjMatrix[v][j];
-                        steps[j] = steps[v] + 1;
-                        
-                        if (steps[j] >= this -> vertexCount)
-                        {
-                            return true;
-                        }
-                        if (!inQueue[j])
-                        {
-                            q.push(j);
-                        }
-                    }
-                }
-            }
+            throw std::out_of_range("Dijkstra: start vertex is out of range");
+        }
+
+        dijkstraTree(this -> vertexCount, start, dist, pred, scratch, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphMatrix<E>::Bellman_Ford(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch, int steps)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("Bellman-ford: start vertex is out of range");
         }
 
-        return true;
+        bellmanFordTree(this -> vertexCount, start, steps, this -> edges, dist, pred, scratch);
+    }
+
+    template <typename E>
+    void GraphMatrix<E>::spfa(Vertex start, vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("spfa: start vertex is out of range");
+        }
+
+        spfaTree(this -> vertexCount, start, dist, pred, scratch, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    bool GraphMatrix<E>::containsNegativeCycle()
+    {
+        return !FindNegativeCycle().empty();
+    }
+
+    template <typename E>
+    vector<Vertex> GraphMatrix<E>::FindNegativeCycle(size_t threads)
+    {
+        if (this -> edges.size() >= NegativeCycleParallelThreshold &&
+            parallelWorkers(this -> edges.size(), threads, 1 << 14) > 1)
+        {
+            const vector<Edge> edgeList(this -> edges.begin(), this -> edges.end());
+            return findNegativeCycleParallel(this -> vertexCount, edgeList, threads);
+        }
+
+        return findNegativeCycle(this -> vertexCount, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
     }
 
     template <typename E>
     MSTResult GraphMatrix<E>::Prim()
+    {
+        return Prim(PrimStrategy::Heap);
+    }
+
+    template <typename E>
+    MSTResult GraphMatrix<E>::Prim(PrimStrategy strategy)
+    {
+        if (strategy == PrimStrategy::Dense)
+        {
+            return PrimDense();
+        }
+        return PrimHeap();
+    }
+
+    template <typename E>
+    MSTResult GraphMatrix<E>::PrimDense()
     {
         vector<int> distences(this -> vertexCount, INF);
-        vector<int> pre(this -> vertexCount, -1);
+        vector<Vertex> pre(this -> vertexCount, 0);
         vector<bool> inMST(this -> vertexCount, false);
         vector<Edge> MSTedges;
         int edgeSum = 0;
+
+        if (this -> vertexCount == 0)
+        {
+            return std::make_pair(0, vector<Edge>());
+        }
+
         distences[0] = 0;
-        
-        for (int i = 0; i < this -> vertexCount; i ++)
+
+        for (Vertex i = 0; i < this -> vertexCount; i ++)
         {
-            int nearNode = -1;
+            Vertex nearNode = this -> vertexCount;
 
             for (Vertex j = 0; j < this -> vertexCount; j ++)
             {
-                if (! inMST[j] && (nearNode == -1 || distences[j] > distences[nearNode]))
+                if (!inMST[j] && (nearNode == this -> vertexCount || distences[j] < distences[nearNode]))
                 {
                     nearNode = j;
                 }
             }
-            
+
             if (distences[nearNode] == INF)
             {
                 return std::make_pair(-1, vector<Edge>()); // 不存在MST
             }
 
             inMST[nearNode] = true;
-            MSTedges.emplace_back(Edge{(Vertex)(pre[nearNode]), (Vertex)(nearNode), distences[nearNode]});
-            edgeSum += distences[nearNode];
+            if (nearNode != 0)
+            {
+                MSTedges.emplace_back(Edge{pre[nearNode], nearNode, distences[nearNode]});
+                edgeSum += distences[nearNode];
+            }
 
             for (Vertex j = 0; j < this -> vertexCount; j ++)
             {
-                if (adjMatrix[nearNode][j] != INF && adjMatrix[nearNode][j] < distences[j])
+                if (!inMST[j] && matrixRow(nearNode)[j] != INF && matrixRow(nearNode)[j] < distences[j])
                 {
-                    distences[j] = adjMatrix[nearNode][j];
+                    distences[j] = matrixRow(nearNode)[j];
                     pre[j] = nearNode;
                 }
             }
@@ -345,18 +580,63 @@ namespace DataStructure
     }
 
     template <typename E>
-    MSTResult GraphMatrix<E>::Kruskal()
+    MSTResult GraphMatrix<E>::PrimHeap()
     {
+        DistanceHeap heap(this -> vertexCount);
+
+        vector<int> distences(this -> vertexCount, INF);
+        vector<Vertex> pre(this -> vertexCount, 0);
+        vector<bool> inMST(this -> vertexCount, false);
         vector<Edge> MSTedges;
         int edgeSum = 0;
-        uint edgeCount = 0;
+        size_t count = 0;
 
-        vector<Vertex> father(this -> vertexCount);
-        for (int i = 0; i < this -> vertexCount; ++i)
+        if (this -> vertexCount == 0)
         {
-            father[i] = i;
+            return std::make_pair(0, vector<Edge>());
         }
 
+        distences[0] = 0;
+        heap.push(0, 0);
+
+        while (!heap.empty())
+        {
+            Vertex nearNode = heap.top();
+            heap.pop();
+
+            inMST[nearNode] = true;
+            count ++;
+            if (nearNode != 0)
+            {
+                MSTedges.emplace_back(Edge{pre[nearNode], nearNode, distences[nearNode]});
+                edgeSum += distences[nearNode];
+            }
+
+            forEachNeighbor(nearNode, [&](Vertex j, int weight) {
+                if (!inMST[j] && weight < distences[j])
+                {
+                    distences[j] = weight;
+                    pre[j] = nearNode;
+                    heap.push_or_decrease(j, weight);
+                }
+            });
+        }
+
+        if (count != this -> vertexCount)
+        {
+            return std::make_pair(-1, vector<Edge>()); // 不存在MST
+        }
+
+        return std::make_pair(edgeSum, std::move(MSTedges));
+    }
+
+    template <typename E>
+    MSTResult GraphMatrix<E>::Kruskal()
+    {
+        vector<Edge> MSTedges;
+        int edgeSum = 0;
+        DisjointSet set(this -> vertexCount);
+
         //边的存储可以直接加一个成员变量，在插入的时候就维护
         vector<Edge> edges{this -> edges.begin(), this -> edges.end()};
 
@@ -364,30 +644,120 @@ namespace DataStructure
             return a.weight < b.weight;
         });
 
-        std::function<Vertex(Vertex)> find = [&](Vertex x) { //有趣的写法
-            if (father[x] != x) {
-                father[x] = find(father[x]);
-            }
-            return father[x];
-        };
-
         for (const auto& edge : edges)
         {
-            Vertex a = edge.from, b = edge.to;
-            if (find(a) != find(b))
+            if (set.unite(edge.from, edge.to))
             {
-                father[find(a)] = find(b);
                 MSTedges.emplace_back(edge);
                 edgeSum += edge.weight;
-                edgeCount ++;
             }
         }
 
-        if (edgeCount != this -> vertexCount - 1)
+        if (MSTedges.size() + 1 != this -> vertexCount)
         {
             return std::make_pair(-1, vector<Edge>());
         }
 
         return std::make_pair(edgeSum, std::move(MSTedges));
     }
-}
\ No newline at end of file
+
+    template <typename E>
+    vector<int> GraphMatrix<E>::DeltaStepping(Vertex start, int delta, size_t threads)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("DeltaStepping: start out of range");
+        }
+
+        return deltaStepping(this -> vertexCount, start, delta, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    vector<int> GraphMatrix<E>::BFS(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("BFS: start vertex is out of range");
+        }
+
+        return breadthFirst(this -> vertexCount, start, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    vector<int> GraphMatrix<E>::DirectionOptimizingBFS(Vertex start)
+    {
+        if (start >= this -> vertexCount)
+        {
+            throw std::out_of_range("DirectionOptimizingBFS: start vertex is out of range");
+        }
+
+        this -> refreshEdgeIndex();
+        const AdjacencyIndex& forward = this -> edgeIndex[0];
+
+        auto predecessors = [this](Vertex v, auto&& visit) {
+            this -> forEachPredecessor(v, visit);
+        };
+        auto degree = [&forward](Vertex v) {
+            return forward.offsets[v + 1] - forward.offsets[v];
+        };
+
+        return directionOptimizingBfs(this -> vertexCount, start, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, predecessors, degree);
+    }
+
+    template <typename E>
+    DistanceMatrix GraphMatrix<E>::MultiSourceBFS(const vector<Vertex>& sources)
+    {
+        for (Vertex source : sources)
+        {
+            if (source >= this -> vertexCount)
+            {
+                throw std::out_of_range("MultiSourceBFS: source vertex out of range");
+            }
+        }
+
+        return multiSourceBfs(this -> vertexCount, sources, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphMatrix<E>::WeakComponents(size_t threads)
+    {
+        return weakComponents(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphMatrix<E>::StrongComponents()
+    {
+        return tarjanComponents(this -> vertexCount, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+
+    template <typename E>
+    ComponentResult GraphMatrix<E>::ParallelStrongComponents(size_t threads)
+    {
+        this -> refreshEdgeIndex();
+        return forwardBackwardComponents(this -> vertexCount, threads, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        }, [this](Vertex v, auto&& visit) {
+            this -> forEachPredecessor(v, visit);
+        });
+    }
+
+    template <typename E>
+    void GraphMatrix<E>::writeBinary(const std::string& path)
+    {
+        writeGraphFile(path, this -> vertexCount, this -> vertices, [this](Vertex v, auto&& visit) {
+            forEachNeighbor(v, visit);
+        });
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace DataStructure
+{
+    inline size_t hardwareThreads()
+    {
+        size_t n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // 把 [0, count) 切成大小为 grain 的块，由 threads 个工作线程动态领取（调用线程也参与）。
+    // func(worker, begin, end)，worker 取值 [0, threads)，可用来索引每个线程私有的工作区。
+    // threads 为 0 时使用硬件线程数。
+    template <typename F>
+    void parallelRange(size_t count, size_t threads, size_t grain, F&& func)
+    {
+        if (count == 0) return;
+        if (threads == 0) threads = hardwareThreads();
+        if (grain == 0) grain = 1;
+        threads = std::min(threads, (count + grain - 1) / grain);
+
+        if (threads <= 1)
+        {
+            func(size_t(0), size_t(0), count);
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        auto work = [&](size_t worker) {
+            while (true)
+            {
+                size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+                if (begin >= count) break;
+                func(worker, begin, std::min(begin + grain, count));
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (size_t i = 1; i < threads; i ++)
+        {
+            pool.emplace_back(work, i);
+        }
+        work(0);
+        for (auto& t : pool)
+        {
+            t.join();
+        }
+    }
+
+    // 返回 parallelRange 实际会使用的线程数，便于调用方预先分配每个线程的工作区
+    inline size_t parallelWorkers(size_t count, size_t threads, size_t grain = 1)
+    {
+        if (threads == 0) threads = hardwareThreads();
+        if (grain == 0) grain = 1;
+        return std::max<size_t>(1, std::min(threads, (count + grain - 1) / grain));
+    }
+
+    // 无锁地把 target 更新为 min(target, value)，返回是否变小
+    inline bool atomicMin(std::atomic<int>& target, int value)
+    {
+        int old = target.load(std::memory_order_relaxed);
+        while (value < old)
+        {
+            if (target.compare_exchange_weak(old, value, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 并行排序：先把区间切成 workers 段分别 std::sort，再逐层两两归并相邻的段
+    template <typename Iter, typename Compare>
+    void parallelSort(Iter first, Iter last, Compare comp, size_t threads = 0)
+    {
+        const size_t n = last - first;
+        const size_t workers = parallelWorkers(n, threads, 1 << 14);
+        if (workers <= 1)
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        std::vector<size_t> bounds(workers + 1);
+        for (size_t i = 0; i <= workers; i ++)
+        {
+            bounds[i] = n * i / workers;
+        }
+
+        parallelRange(workers, workers, 1, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i ++)
+            {
+                std::sort(first + bounds[i], first + bounds[i + 1], comp);
+            }
+        });
+
+        for (size_t width = 1; width < workers; width *= 2)
+        {
+            const size_t pairs = (workers + 2 * width - 1) / (2 * width);
+            parallelRange(pairs, workers, 1, [&](size_t, size_t begin, size_t end) {
+                for (size_t p = begin; p < end; p ++)
+                {
+                    size_t lo = p * 2 * width;
+                    size_t mid = std::min(lo + width, workers);
+                    size_t hi = std::min(lo + 2 * width, workers);
+                    if (mid < hi)
+                    {
+                        std::inplace_merge(first + bounds[lo], first + bounds[mid], first + bounds[hi], comp);
+                    }
+                }
+            });
+        }
+    }
+}
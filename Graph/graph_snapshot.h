@@ -0,0 +1,131 @@
+#pragma once
+#include "graph.h"
+#include "graph_csr.h"
+#include "graph_list.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace DataStructure
+{
+    // 读多写少的并发图：写者在内部的 GraphList 上累积修改，publish 时冻结成 GraphCSR，
+    // 再用一次原子的指针替换发布出去。读者用 snapshot() 取得当前版本的 shared_ptr，
+    // 之后的读取不加锁，也看不到后续的修改；旧版本在最后一个持有它的读者释放后自动回收。
+    //
+    // 快照发布前已经建好正反向邻接（refreshEdgeIndex），所以 Dijkstra、getAdjacentVertices、
+    // BFS 系列、连通分量等只读查询可以由多个线程同时在同一个快照上调用；
+    // shortestPath 使用对象内的工作区，同一快照上不能并发调用。快照上的修改函数会抛出 std::logic_error。
+    template <typename E>
+    class SnapshotGraph
+    {
+    public:
+        using Snapshot = std::shared_ptr<GraphCSR<E>>;
+
+        SnapshotGraph(size_t vertexCount);
+        SnapshotGraph(const GraphList<E>& graph);
+
+        // 写者接口，多个写者之间用互斥锁串行化，不影响读者
+        void addEdge(Vertex from, Vertex to, int weight = 1);
+        void removeEdge(Vertex from, Vertex to);
+        void setVertex(Vertex vertex, E value);
+        // 在锁内对 GraphList 做任意修改，例如一批 addEdge
+        template <typename F>
+        void modify(F&& func);
+        // 把目前为止的修改发布成新版本，返回新版本号；没有修改时不重建，直接返回当前版本号
+        uint64_t publish();
+
+        // 读者接口
+        Snapshot snapshot() const;
+        uint64_t version() const;       // 最近一次发布的版本号，构造时为 0
+
+    private:
+        void install();
+
+        mutable std::mutex writeLock;
+        GraphList<E> writer;
+        bool dirty = false;
+        Snapshot current;               // 只通过 std::atomic_load / std::atomic_store 访问
+        std::atomic<uint64_t> published;
+    };
+
+    template <typename E>
+    SnapshotGraph<E>::SnapshotGraph(size_t vertexCount) : writer(vertexCount), published(0)
+    {
+        install();
+    }
+
+    template <typename E>
+    SnapshotGraph<E>::SnapshotGraph(const GraphList<E>& graph) : writer(graph), published(0)
+    {
+        install();
+    }
+
+    template <typename E>
+    void SnapshotGraph<E>::install()
+    {
+        Snapshot next = std::make_shared<GraphCSR<E>>(writer);
+        next -> refreshEdgeIndex();
+        std::atomic_store(&current, std::move(next));
+        dirty = false;
+    }
+
+    template <typename E>
+    void SnapshotGraph<E>::addEdge(Vertex from, Vertex to, int weight)
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        writer.addEdge(from, to, weight);
+        dirty = true;
+    }
+
+    template <typename E>
+    void SnapshotGraph<E>::removeEdge(Vertex from, Vertex to)
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        writer.removeEdge(from, to);
+        dirty = true;
+    }
+
+    template <typename E>
+    void SnapshotGraph<E>::setVertex(Vertex vertex, E value)
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        writer.setVertex(vertex, std::move(value));
+        dirty = true;
+    }
+
+    template <typename E>
+    template <typename F>
+    void SnapshotGraph<E>::modify(F&& func)
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        dirty = true;
+        func(writer);
+    }
+
+    template <typename E>
+    uint64_t SnapshotGraph<E>::publish()
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        if (!dirty)
+        {
+            return published.load(std::memory_order_relaxed);
+        }
+
+        install();
+        return published.fetch_add(1, std::memory_order_release) + 1;
+    }
+
+    template <typename E>
+    typename SnapshotGraph<E>::Snapshot SnapshotGraph<E>::snapshot() const
+    {
+        return std::atomic_load(&current);
+    }
+
+    template <typename E>
+    uint64_t SnapshotGraph<E>::version() const
+    {
+        return published.load(std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "graph.h"
+#include "graph_parallel.h"
+#include "negative_cycle.h"
+#include <stdexcept>
+#include <vector>
+
+namespace DataStructure
+{
+    // Johnson 全源最短路：先从连向所有顶点的虚拟源点求势 h（见 findNegativeCycle），
+    // 把边权改成 w + h[u] - h[v] >= 0，再对每个源点并行跑 Dijkstra，最后把距离换回原边权。
+    // 稀疏图上为 O(V E log V)，比 O(V^3) 的 Floyd 快得多。有负权环时抛出 std::runtime_error。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)，并且可以被多个线程同时调用；
+    // row(s) 返回源点 s 那一行（长度 vertexCount）的写入位置，例如 DistanceMatrix::row。
+    template <typename Neighbors, typename Rows>
+    void johnson(size_t vertexCount, size_t threads, Neighbors&& neighbors, Rows&& row)
+    {
+        vector<int> potential;
+        if (!findNegativeCycle(vertexCount, neighbors, &potential).empty())
+        {
+            throw std::runtime_error("johnson: negative cycle");
+        }
+
+        size_t workers = parallelWorkers(vertexCount, threads);
+        vector<ShortestPathScratch> scratch(workers, ShortestPathScratch(vertexCount));
+
+        parallelRange(vertexCount, workers, 1, [&](size_t worker, size_t begin, size_t end) {
+            DistanceHeap& heap = scratch[worker].heap;
+            vector<bool>& visited = scratch[worker].visited;
+
+            for (Vertex start = begin; start < end; start ++)
+            {
+                int* ans = row(start);
+                std::fill(ans, ans + vertexCount, INF);
+                std::fill(visited.begin(), visited.end(), false);
+
+                ans[start] = 0;
+                heap.push(start, 0);
+                while (!heap.empty())
+                {
+                    Vertex v = heap.top();
+                    int distance = heap.top_key();
+                    heap.pop();
+                    visited[v] = true;
+
+                    neighbors(v, [&](Vertex to, int weight) {
+                        int reduced = distance + weight + potential[v] - potential[to];
+                        if (!visited[to] && ans[to] > reduced)
+                        {
+                            ans[to] = reduced;
+                            heap.push_or_decrease(to, reduced);
+                        }
+                    });
+                }
+
+                for (Vertex v = 0; v < vertexCount; v ++)
+                {
+                    if (ans[v] != INF)
+                    {
+                        ans[v] += potential[v] - potential[start];
+                    }
+                }
+            }
+        });
+    }
+}
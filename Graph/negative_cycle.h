@@ -0,0 +1,219 @@
+#pragma once
+#include "graph.h"
+#include "graph_parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace DataStructure
+{
+    // 边数不少于这个值且有多个线程可用时，负权环查找改用按边并行的松弛
+    constexpr size_t NegativeCycleParallelThreshold = 1 << 20;
+
+    // 以下函数返回一个负权环上的顶点，cycle[i] -> cycle[i + 1] 和 cycle.back() -> cycle.front() 都是图中的边；
+    // 没有负权环时返回空数组。相当于从一个连向所有顶点、边权为 0 的虚拟源点出发求最短路。
+
+    // Tarjan 的子树拆解（subtree disassembly）：维护最短路树的先序链表，
+    // 松弛 u -> v 时先把 v 的子树摘下来，子树中出现 u 就说明前驱图成环，即找到负权环；
+    // 被摘下的顶点在距离再次变小之前不会被扫描。队列是长度为 vertexCount 的环形缓冲区。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)。
+    // potential 不为空且没有负权环时，写入虚拟源点到每个顶点的最短距离（Johnson 重新赋权用的势）。
+    template <typename Neighbors>
+    vector<Vertex> findNegativeCycle(size_t vertexCount, Neighbors&& neighbors, vector<int>* potential = nullptr)
+    {
+        if (vertexCount == 0) return {};
+
+        const Vertex root = vertexCount;    // 虚拟源点
+        vector<int> dist(vertexCount + 1, 0);
+        vector<Vertex> parent(vertexCount + 1, root);
+        vector<size_t> depth(vertexCount + 1, 1);
+        vector<bool> inTree(vertexCount + 1, true);
+        vector<bool> inQueue(vertexCount, true);
+        depth[root] = 0;
+
+        // 循环的先序链表：root, 0, 1, ..., vertexCount - 1
+        vector<Vertex> next(vertexCount + 1), prev(vertexCount + 1);
+        for (Vertex v = 0; v <= vertexCount; v ++)
+        {
+            next[v] = v == vertexCount - 1 ? root : (v == root ? 0 : v + 1);
+            prev[v] = v == 0 ? root : (v == root ? vertexCount - 1 : v - 1);
+        }
+
+        vector<Vertex> queue(vertexCount);
+        for (Vertex v = 0; v < vertexCount; v ++)
+        {
+            queue[v] = v;
+        }
+        size_t head = 0, size = vertexCount;
+
+        vector<Vertex> cycle;
+        while (size > 0 && cycle.empty())
+        {
+            Vertex u = queue[head];
+            head = (head + 1) % vertexCount;
+            size --;
+            inQueue[u] = false;
+            if (!inTree[u]) continue;
+
+            neighbors(u, [&](Vertex v, int weight) {
+                if (!cycle.empty() || dist[u] + weight >= dist[v]) return;
+                dist[v] = dist[u] + weight;
+
+                if (inTree[v])
+                {
+                    Vertex x = next[v];
+                    while (depth[x] > depth[v])
+                    {
+                        if (x == u)
+                        {
+                            // u 在 v 的子树中：v -> ... -> u -> v 是负权环
+                            for (Vertex w = u; w != v; w = parent[w])
+                            {
+                                cycle.push_back(w);
+                            }
+                            cycle.push_back(v);
+                            std::reverse(cycle.begin(), cycle.end());
+                            return;
+                        }
+                        inTree[x] = false;
+                        x = next[x];
+                    }
+                    next[prev[v]] = x;
+                    prev[x] = prev[v];
+                }
+
+                parent[v] = u;
+                depth[v] = depth[u] + 1;
+                inTree[v] = true;
+                next[v] = next[u];
+                prev[next[u]] = v;
+                next[u] = v;
+                prev[v] = u;
+
+                if (!inQueue[v])
+                {
+                    inQueue[v] = true;
+                    queue[(head + size) % vertexCount] = v;
+                    size ++;
+                }
+            });
+        }
+
+        if (potential != nullptr && cycle.empty())
+        {
+            potential -> assign(dist.begin(), dist.begin() + vertexCount);
+        }
+        return cycle;
+    }
+
+    // 按边并行的 Bellman-Ford。每个顶点的 (距离, 前驱边号) 打包在一个 64 位原子量里一起更新，
+    // 每轮松弛之后检查一次前驱图是否成环，成环且总权值为负就返回这个环；某一轮没有松弛说明没有负权环。
+    inline vector<Vertex> findNegativeCycleParallel(size_t vertexCount, const vector<Edge>& edges, size_t threads)
+    {
+        if (edges.size() >= (uint64_t(1) << 32) - 1)
+        {
+            throw std::length_error("findNegativeCycleParallel: too many edges");
+        }
+
+        constexpr uint32_t noEdge = ~uint32_t(0);
+        auto pack = [](int distance, uint32_t edge) {
+            return (uint64_t(static_cast<uint32_t>(distance) ^ 0x80000000u) << 32) | edge;
+        };
+        auto distanceOf = [](uint64_t label) {
+            return static_cast<int>(static_cast<uint32_t>(label >> 32) ^ 0x80000000u);
+        };
+
+        vector<std::atomic<uint64_t>> label(vertexCount);
+        for (auto& l : label)
+        {
+            l.store(pack(0, noEdge), std::memory_order_relaxed);
+        }
+
+        vector<uint32_t> pred(vertexCount);
+        vector<char> state(vertexCount);
+        vector<Vertex> path;
+
+        // 在前驱图（每个顶点至多一条前驱边）中找环，找到负权环就写入 cycle
+        auto findCycle = [&](vector<Vertex>& cycle) {
+            for (Vertex v = 0; v < vertexCount; v ++)
+            {
+                pred[v] = static_cast<uint32_t>(label[v].load(std::memory_order_relaxed));
+            }
+            std::fill(state.begin(), state.end(), 0);
+
+            for (Vertex start = 0; start < vertexCount; start ++)
+            {
+                path.clear();
+                Vertex v = start;
+                while (state[v] == 0)
+                {
+                    state[v] = 1;
+                    path.push_back(v);
+                    if (pred[v] == noEdge) break;
+                    v = edges[pred[v]].from;
+                }
+
+                if (state[v] == 1 && pred[v] != noEdge)
+                {
+                    // v 在本次路径上，沿前驱从 v 走回 v 就是一个环
+                    long long weight = 0;
+                    cycle.clear();
+                    Vertex w = v;
+                    do
+                    {
+                        cycle.push_back(w);
+                        weight += edges[pred[w]].weight;
+                        w = edges[pred[w]].from;
+                    } while (w != v);
+
+                    if (weight < 0)
+                    {
+                        std::reverse(cycle.begin(), cycle.end());
+                        return true;
+                    }
+                    cycle.clear();
+                }
+
+                for (Vertex x : path)
+                {
+                    state[x] = 2;
+                }
+            }
+            return false;
+        };
+
+        vector<Vertex> cycle;
+        for (size_t round = 0; round < vertexCount; round ++)
+        {
+            std::atomic<bool> relaxed(false);
+            parallelRange(edges.size(), threads, 1 << 14, [&](size_t, size_t begin, size_t end) {
+                bool local = false;
+                for (size_t i = begin; i < end; i ++)
+                {
+                    const Edge& e = edges[i];
+                    int candidate = distanceOf(label[e.from].load(std::memory_order_relaxed)) + e.weight;
+                    uint64_t old = label[e.to].load(std::memory_order_relaxed);
+                    while (candidate < distanceOf(old))
+                    {
+                        if (label[e.to].compare_exchange_weak(old, pack(candidate, static_cast<uint32_t>(i)),
+                                                               std::memory_order_relaxed))
+                        {
+                            local = true;
+                            break;
+                        }
+                    }
+                }
+                if (local)
+                {
+                    relaxed.store(true, std::memory_order_relaxed);
+                }
+            });
+
+            if (!relaxed.load(std::memory_order_relaxed)) return {};
+            if (findCycle(cycle)) return cycle;
+        }
+
+        return {};
+    }
+}
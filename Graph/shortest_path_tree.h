@@ -0,0 +1,167 @@
+#pragma once
+#include "graph.h"
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace DataStructure
+{
+    // 前驱数组中表示“没有前驱”的值：起点和不可达的顶点
+    constexpr Vertex NoVertex = ~Vertex(0);
+
+    // 沿前驱数组从 to 走回起点的惰性路径，按 to、pred[to]、... 、起点 的顺序产生顶点，不分配内存。
+    // to 不可达时为空。前驱数组在遍历期间必须保持有效。
+    class PredecessorPath
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Vertex;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Vertex*;
+            using reference = Vertex;
+
+            const_iterator(const vector<Vertex>* pred, Vertex current) : pred(pred), current(current) {}
+            Vertex operator*() const { return current; }
+            const_iterator& operator++() { current = (*pred)[current]; return *this; }
+            const_iterator operator++(int) { const_iterator old = *this; ++ *this; return old; }
+            bool operator==(const const_iterator& other) const { return current == other.current; }
+            bool operator!=(const const_iterator& other) const { return current != other.current; }
+
+        private:
+            const vector<Vertex>* pred;
+            Vertex current;
+        };
+
+    public:
+        // dist 用来判断 to 是否可达；起点自己也是一条只有一个顶点的路径
+        PredecessorPath(const vector<Vertex>& pred, const vector<int>& dist, Vertex to)
+            : pred(&pred), to(dist[to] == INF ? NoVertex : to) {}
+
+        const_iterator begin() const { return const_iterator(pred, to); }
+        const_iterator end() const { return const_iterator(pred, NoVertex); }
+        bool empty() const { return to == NoVertex; }
+
+    private:
+        const vector<Vertex>* pred;
+        Vertex to;
+    };
+
+    // 以下函数把距离和最短路树写入调用方提供的 dist / pred，两者长度不是 vertexCount 时才重新分配，
+    // 工作区在多次调用之间复用，因此重复查询不再分配内存。pred[v] 为最短路上 v 的前一个顶点。
+    inline void resetShortestPathTree(size_t vertexCount, Vertex start, vector<int>& dist, vector<Vertex>& pred)
+    {
+        dist.assign(vertexCount, INF);
+        pred.assign(vertexCount, NoVertex);
+        dist[start] = 0;
+    }
+
+    // Dijkstra，边权需非负。neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)。
+    template <typename Neighbors>
+    void dijkstraTree(size_t vertexCount, Vertex start, vector<int>& dist, vector<Vertex>& pred,
+                      ShortestPathScratch& scratch, Neighbors&& neighbors)
+    {
+        resetShortestPathTree(vertexCount, start, dist, pred);
+        DistanceHeap& heap = scratch.heap;
+        vector<bool>& visited = scratch.visited;
+        visited.assign(vertexCount, false);
+
+        heap.push(start, 0);
+        while (!heap.empty())
+        {
+            Vertex v = heap.top();
+            int distance = heap.top_key();
+            heap.pop();
+            visited[v] = true;
+
+            neighbors(v, [&](Vertex to, int weight) {
+                if (!visited[to] && dist[to] > distance + weight)
+                {
+                    dist[to] = distance + weight;
+                    pred[to] = v;
+                    heap.push_or_decrease(to, dist[to]);
+                }
+            });
+        }
+    }
+
+    // 先进先出的 spfa，队列是长度为 vertexCount 的环形缓冲区（每个顶点最多在队列中出现一次）。
+    // 某个顶点的最短路边数达到 vertexCount 时说明存在从 start 可达的负权环，抛出 std::runtime_error。
+    template <typename Neighbors>
+    void spfaTree(size_t vertexCount, Vertex start, vector<int>& dist, vector<Vertex>& pred,
+                  ShortestPathScratch& scratch, Neighbors&& neighbors)
+    {
+        resetShortestPathTree(vertexCount, start, dist, pred);
+        vector<bool>& inQueue = scratch.visited;
+        vector<Vertex>& queue = scratch.queue;
+        vector<int>& hops = scratch.hops;
+        inQueue.assign(vertexCount, false);
+        queue.resize(vertexCount);
+        hops.assign(vertexCount, 0);
+
+        size_t head = 0, size = 0;
+        auto push = [&](Vertex v) {
+            queue[(head + size) % vertexCount] = v;
+            size ++;
+            inQueue[v] = true;
+        };
+
+        push(start);
+        while (size > 0)
+        {
+            Vertex v = queue[head];
+            head = (head + 1) % vertexCount;
+            size --;
+            inQueue[v] = false;
+
+            neighbors(v, [&](Vertex to, int weight) {
+                if (dist[to] > dist[v] + weight)
+                {
+                    dist[to] = dist[v] + weight;
+                    pred[to] = v;
+                    hops[to] = hops[v] + 1;
+
+                    if (static_cast<size_t>(hops[to]) >= vertexCount)
+                    {
+                        throw std::runtime_error("spfa: negative cycle reachable from start");
+                    }
+                    if (!inQueue[to])
+                    {
+                        push(to);
+                    }
+                }
+            });
+        }
+    }
+
+    // Bellman-Ford，steps 与 Bellman_Ford 的含义相同（最多经过 steps 条边，-1 表示 vertexCount - 1），
+    // 某一轮没有松弛就提前结束。不可达的顶点不参与松弛，距离保持 INF。
+    // edges 为 (from, to, weight) 的边集，例如 Graph 的 EdgeMap。
+    template <typename EdgeRange>
+    void bellmanFordTree(size_t vertexCount, Vertex start, int steps, const EdgeRange& edges,
+                         vector<int>& dist, vector<Vertex>& pred, ShortestPathScratch& scratch)
+    {
+        resetShortestPathTree(vertexCount, start, dist, pred);
+        vector<int>& last = scratch.last;
+
+        if (steps == -1) steps = static_cast<int>(vertexCount) - 1;
+
+        for (int i = 0; i < steps; ++ i)
+        {
+            last = dist;
+            bool relaxed = false;
+            for (const auto& e : edges)
+            {
+                if (last[e.from] != INF && dist[e.to] > last[e.from] + e.weight)
+                {
+                    dist[e.to] = last[e.from] + e.weight;
+                    pred[e.to] = e.from;
+                    relaxed = true;
+                }
+            }
+            if (!relaxed) break;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "graph.h"
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace DataStructure
+{
+    // spfa 的队列策略
+    enum class SpfaQueue
+    {
+        Fifo,               // 普通先进先出
+        SmallLabelFirst,    // SLF：入队顶点的距离比队首小时放到队首
+        LargeLabelLast,     // LLL：队首距离大于队列平均距离时移到队尾
+        SlfLll,             // SLF 与 LLL 同时使用
+        Pape                // D'Esopo-Pape：曾经出过队的顶点再次入队时放到队首
+    };
+
+    // 按 strategy 维护队列的 spfa。maxPops 非 0 时，出队次数超过它就抛出 std::runtime_error；
+    // 某个顶点的最短路边数达到 vertexCount 时说明存在从 start 可达的负权环，同样抛出 std::runtime_error。
+    // neighbors(v, visit) 需要对 v 的每条出边调用 visit(to, weight)。
+    template <typename Neighbors>
+    vector<int> spfaWithQueue(size_t vertexCount, Vertex start, SpfaQueue strategy, size_t maxPops, Neighbors&& neighbors)
+    {
+        const bool slf = strategy == SpfaQueue::SmallLabelFirst || strategy == SpfaQueue::SlfLll;
+        const bool lll = strategy == SpfaQueue::LargeLabelLast || strategy == SpfaQueue::SlfLll;
+        const bool pape = strategy == SpfaQueue::Pape;
+
+        vector<int> ans(vertexCount, INF);
+        vector<size_t> steps(vertexCount, 0);
+        vector<bool> inQueue(vertexCount, false);
+        vector<bool> wasQueued(vertexCount, false);
+        std::deque<Vertex> q;
+        long long queueSum = 0;     // 队列中顶点距离之和，供 LLL 使用
+        size_t pops = 0;
+
+        auto push = [&](Vertex v) {
+            bool front = false;
+            if (slf)
+            {
+                front = !q.empty() && ans[v] < ans[q.front()];
+            }
+            else if (pape)
+            {
+                front = wasQueued[v];
+            }
+
+            if (front)
+            {
+                q.push_front(v);
+            }
+            else
+            {
+                q.push_back(v);
+            }
+            inQueue[v] = true;
+            wasQueued[v] = true;
+            queueSum += ans[v];
+        };
+
+        ans[start] = 0;
+        push(start);
+
+        while (!q.empty())
+        {
+            if (lll)
+            {
+                // 队首比平均值大就挪到队尾，最多转一圈
+                for (size_t i = q.size(); i > 1 && (long long)ans[q.front()] * (long long)q.size() > queueSum; i --)
+                {
+                    q.push_back(q.front());
+                    q.pop_front();
+                }
+            }
+
+            Vertex v = q.front();
+            q.pop_front();
+            inQueue[v] = false;
+            queueSum -= ans[v];
+
+            if (maxPops != 0 && ++ pops > maxPops)
+            {
+                throw std::runtime_error("spfa: iteration limit exceeded");
+            }
+
+            neighbors(v, [&](Vertex to, int weight) {
+                if (ans[to] > ans[v] + weight)
+                {
+                    if (inQueue[to])
+                    {
+                        queueSum -= ans[to] - (ans[v] + weight);
+                    }
+                    ans[to] = ans[v] + weight;
+                    steps[to] = steps[v] + 1;
+
+                    if (steps[to] >= vertexCount)
+                    {
+                        throw std::runtime_error("spfa: negative cycle reachable from start");
+                    }
+
+                    if (!inQueue[to])
+                    {
+                        push(to);
+                    }
+                }
+            });
+        }
+
+        return ans;
+    }
+}
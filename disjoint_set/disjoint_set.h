@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace DataStructure
+{
+    // 并查集：按集合大小合并，查找时做路径减半（迭代实现，不会爆栈）
+    class DisjointSet
+    {
+    public:
+        DisjointSet(size_t n = 0);
+        ~DisjointSet() = default;
+
+        void reset(size_t n);
+        size_t find(size_t x);                  // 查找代表元，同时路径减半
+        size_t find(size_t x) const;            // 只读查找，不修改结构，可被多个线程同时调用
+        bool unite(size_t a, size_t b);         // 合并，已在同一集合返回 false
+        bool connected(size_t a, size_t b);
+        size_t size(size_t x);                  // x 所在集合的大小
+        size_t count() const;                   // 集合个数
+        size_t capacity() const;
+
+    private:
+        std::vector<size_t> m_parent;
+        std::vector<size_t> m_size;
+        size_t m_count;
+    };
+
+    inline DisjointSet::DisjointSet(size_t n)
+    {
+        reset(n);
+    }
+
+    inline void DisjointSet::reset(size_t n)
+    {
+        m_parent.resize(n);
+        std::iota(m_parent.begin(), m_parent.end(), size_t(0));
+        m_size.assign(n, 1);
+        m_count = n;
+    }
+
+    inline size_t DisjointSet::find(size_t x)
+    {
+        if (x >= m_parent.size())
+        {
+            throw std::out_of_range("DisjointSet::find: element out of range");
+        }
+        while (m_parent[x] != x)
+        {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    }
+
+    inline size_t DisjointSet::find(size_t x) const
+    {
+        if (x >= m_parent.size())
+        {
+            throw std::out_of_range("DisjointSet::find: element out of range");
+        }
+        while (m_parent[x] != x)
+        {
+            x = m_parent[x];
+        }
+        return x;
+    }
+
+    inline bool DisjointSet::unite(size_t a, size_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+        {
+            return false;
+        }
+        if (m_size[a] < m_size[b])
+        {
+            std::swap(a, b);
+        }
+        m_parent[b] = a;
+        m_size[a] += m_size[b];
+        m_count --;
+        return true;
+    }
+
+    inline bool DisjointSet::connected(size_t a, size_t b)
+    {
+        return find(a) == find(b);
+    }
+
+    inline size_t DisjointSet::size(size_t x)
+    {
+        return m_size[find(x)];
+    }
+
+    inline size_t DisjointSet::count() const
+    {
+        return m_count;
+    }
+
+    inline size_t DisjointSet::capacity() const
+    {
+        return m_parent.size();
+    }
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -145,4 +148,231 @@ namespace Da
         m_container.show();
     }
 
+    // 带索引的 d 叉堆：元素以 [0, capacity) 内的下标标识，可以按下标查找位置并调整键值，
+    // 堆中同一下标至多出现一次，因此 Dijkstra / Prim 的堆大小不超过顶点数。
+    // Compare 的语义与 Heap 相同：std::less 为大根堆，std::greater 为小根堆。
+    template <typename T, typename Compare = std::less<T>, int D = 4>
+    class IndexedHeap
+    {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+    public:
+        IndexedHeap(size_t capacity = 0);
+        ~IndexedHeap();
+
+        void resize(size_t capacity);                       // 调整下标范围，同时清空堆
+        void push(size_t index, const T & key);
+        void decrease_key(size_t index, const T & key);     // 把 index 的键值向堆顶方向调整
+        bool push_or_decrease(size_t index, const T & key); // 不在堆中则插入，否则在更优时调整
+        void pop();
+        size_t top() const;
+        const T & top_key() const;
+        const T & key(size_t index) const;
+        bool contains(size_t index) const;
+        size_t position(size_t index) const;                // 堆中的位置，不在堆中返回 npos
+        bool empty() const;
+        int size() const;
+        size_t capacity() const;
+        void clear();
+
+    private:
+        void sift_up(size_t pos);
+        void sift_down(size_t pos);
+        void place(size_t pos, const std::pair<T, size_t> & node);
+
+    private:
+        std::vector<std::pair<T, size_t>> m_container;     // (键值, 下标)
+        std::vector<size_t> m_position;
+        Compare m_compare;
+    };
+
+    template <typename T, typename Compare, int D>
+    IndexedHeap<T, Compare, D>::IndexedHeap(size_t capacity) : m_position(capacity, npos) {}
+
+    template <typename T, typename Compare, int D>
+    IndexedHeap<T, Compare, D>::~IndexedHeap() {}
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::resize(size_t capacity)
+    {
+        m_container.clear();
+        m_position.assign(capacity, npos);
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::place(size_t pos, const std::pair<T, size_t> & node)
+    {
+        m_container[pos] = node;
+        m_position[node.second] = pos;
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::sift_up(size_t pos)
+    {
+        auto node = m_container[pos];
+        while (pos > 0)
+        {
+            size_t parent = (pos - 1) / D;
+            if (!m_compare(m_container[parent].first, node.first))
+            {
+                break;
+            }
+            place(pos, m_container[parent]);
+            pos = parent;
+        }
+        place(pos, node);
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::sift_down(size_t pos)
+    {
+        size_t size = m_container.size();
+        auto node = m_container[pos];
+        while (true)
+        {
+            size_t first = pos * D + 1;
+            if (first >= size)
+            {
+                break;
+            }
+            size_t last = std::min(first + D, size);
+            size_t best = first;
+            for (size_t child = first + 1; child < last; child ++)
+            {
+                if (m_compare(m_container[best].first, m_container[child].first))
+                {
+                    best = child;
+                }
+            }
+            if (!m_compare(node.first, m_container[best].first))
+            {
+                break;
+            }
+            place(pos, m_container[best]);
+            pos = best;
+        }
+        place(pos, node);
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::push(size_t index, const T & key)
+    {
+        if (index >= m_position.size())
+        {
+            throw std::out_of_range("IndexedHeap::push: index out of range");
+        }
+        if (m_position[index] != npos)
+        {
+            throw std::logic_error("IndexedHeap::push: index already in heap");
+        }
+        m_container.emplace_back(key, index);
+        sift_up(m_container.size() - 1);
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::decrease_key(size_t index, const T & key)
+    {
+        if (!contains(index))
+        {
+            throw std::logic_error("IndexedHeap::decrease_key: index not in heap");
+        }
+        size_t pos = m_position[index];
+        if (m_compare(key, m_container[pos].first))
+        {
+            throw std::logic_error("IndexedHeap::decrease_key: new key moves away from the top");
+        }
+        m_container[pos].first = key;
+        sift_up(pos);
+    }
+
+    template <typename T, typename Compare, int D>
+    bool IndexedHeap<T, Compare, D>::push_or_decrease(size_t index, const T & key)
+    {
+        if (!contains(index))
+        {
+            push(index, key);
+            return true;
+        }
+        size_t pos = m_position[index];
+        if (!m_compare(m_container[pos].first, key))
+        {
+            return false;
+        }
+        m_container[pos].first = key;
+        sift_up(pos);
+        return true;
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::pop()
+    {
+        m_position[m_container.front().second] = npos;
+        auto last = m_container.back();
+        m_container.pop_back();
+        if (!m_container.empty())
+        {
+            m_container[0] = last;
+            sift_down(0);
+        }
+    }
+
+    template <typename T, typename Compare, int D>
+    size_t IndexedHeap<T, Compare, D>::top() const
+    {
+        return m_container.front().second;
+    }
+
+    template <typename T, typename Compare, int D>
+    const T & IndexedHeap<T, Compare, D>::top_key() const
+    {
+        return m_container.front().first;
+    }
+
+    template <typename T, typename Compare, int D>
+    const T & IndexedHeap<T, Compare, D>::key(size_t index) const
+    {
+        return m_container[m_position[index]].first;
+    }
+
+    template <typename T, typename Compare, int D>
+    bool IndexedHeap<T, Compare, D>::contains(size_t index) const
+    {
+        return index < m_position.size() && m_position[index] != npos;
+    }
+
+    template <typename T, typename Compare, int D>
+    size_t IndexedHeap<T, Compare, D>::position(size_t index) const
+    {
+        return index < m_position.size() ? m_position[index] : npos;
+    }
+
+    template <typename T, typename Compare, int D>
+    bool IndexedHeap<T, Compare, D>::empty() const
+    {
+        return m_container.empty();
+    }
+
+    template <typename T, typename Compare, int D>
+    int IndexedHeap<T, Compare, D>::size() const
+    {
+        return m_container.size();
+    }
+
+    template <typename T, typename Compare, int D>
+    size_t IndexedHeap<T, Compare, D>::capacity() const
+    {
+        return m_position.size();
+    }
+
+    template <typename T, typename Compare, int D>
+    void IndexedHeap<T, Compare, D>::clear()
+    {
+        for (const auto & node : m_container)
+        {
+            m_position[node.second] = npos;
+        }
+        m_container.clear();
+    }
+
 }